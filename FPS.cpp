@@ -1,42 +1,98 @@
 #include "FPS.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <thread>
+#include <vector>
 
+#include "common.hpp"
 #include "log.hpp"
 
 namespace {
 
+using clock = std::chrono::steady_clock;
+
+// Single producer, single consumer
+// Timestamps only grow, so a slot newer than the last one read is new and
+// producer publishes with the value itself
+alignas( g_cacheLineSize ) std::array< std::atomic< int64_t >,
+                                       FPS::g_capacity > g_timestamps{};
+// Producer only
+size_t g_writeIndex = 0;
+
 std::jthread g_loggerThread;
 
-void logger( const std::stop_token& _stopToken,
-             std::atomic< size_t >& _frameCount ) {
-    using clock = std::chrono::steady_clock;
+auto now() -> int64_t {
+    return ( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                 clock::now().time_since_epoch() )
+                 .count() );
+}
+
+void report( std::vector< int64_t >& _frameTimes ) {
+    if ( _frameTimes.empty() ) {
+        log::info( log::category_t::frame, "Frame time: no frames" );
+
+        return;
+    }
+
+    const timeSummary_t l_summary = summarize( _frameTimes );
+
+    const double l_hitchThreshold =
+        ( l_summary.p50 *
+          static_cast< double >( g_oneMillisecondInNanoseconds ) *
+          FPS::g_hitchFactor );
+
+    const auto l_hitches = std::ranges::count_if(
+        _frameTimes, [ & ]( int64_t _frameTime ) {
+            return ( static_cast< double >( _frameTime ) > l_hitchThreshold );
+        } );
+
+    log::info( log::category_t::frame,
+               "FPS: {:.2f}, frame time ms: min {:.2f}, avg {:.2f}, p50 "
+               "{:.2f}, p95 {:.2f}, p99 {:.2f}, max {:.2f}, hitches {}",
+               ( static_cast< double >( g_oneSecondInMilliseconds ) /
+                 l_summary.mean ),
+               l_summary.min, l_summary.mean, l_summary.p50, l_summary.p95,
+               l_summary.p99, l_summary.max, l_hitches );
+}
+
+void logger( const std::stop_token& _stopToken ) {
     using namespace std::chrono_literals;
 
-    auto l_timeLast = clock::now();
+    size_t l_readIndex = 0;
+    int64_t l_lastTimestamp = 0;
+
+    std::vector< int64_t > l_frameTimes;
+
+    l_frameTimes.reserve( FPS::g_capacity );
 
     while ( !_stopToken.stop_requested() ) {
         std::this_thread::sleep_for( 1s );
 
-        const auto l_timeNow = clock::now();
-
-        {
-            const auto l_framesCount = _frameCount.exchange( 0 );
+        l_frameTimes.clear();
 
-            const auto l_frameDuration = ( l_timeNow - l_timeLast );
-            const std::chrono::duration< double > l_frameDurationInSeconds =
-                l_frameDuration;
+        for ( size_t l_read = 0; l_read < FPS::g_capacity; l_read++ ) {
+            const int64_t l_timestamp =
+                g_timestamps[ l_readIndex % FPS::g_capacity ].load(
+                    std::memory_order_relaxed );
 
-            double l_FPS = 0;
+            if ( l_timestamp <= l_lastTimestamp ) {
+                break;
+            }
 
-            if ( l_frameDurationInSeconds > 0s ) {
-                l_FPS = ( l_framesCount / l_frameDurationInSeconds.count() );
+            // First frame only marks start
+            if ( l_lastTimestamp ) {
+                l_frameTimes.push_back( l_timestamp - l_lastTimestamp );
             }
 
-            log::info( std::format( "FPS: {:.2f}", l_FPS ) );
+            l_lastTimestamp = l_timestamp;
+            l_readIndex++;
         }
 
-        l_timeLast = l_timeNow;
+        report( l_frameTimes );
     }
 
     log::info( "FPS logger stopped." );
@@ -46,8 +102,8 @@ void logger( const std::stop_token& _stopToken,
 
 namespace FPS {
 
-void init( std::atomic< size_t >& _frameCount ) {
-    g_loggerThread = std::jthread( logger, std::ref( _frameCount ) );
+void init() {
+    g_loggerThread = std::jthread( logger );
 }
 
 void quit() {
@@ -58,4 +114,11 @@ void quit() {
     }
 }
 
+void frame() {
+    g_timestamps[ g_writeIndex % g_capacity ].store(
+        now(), std::memory_order_relaxed );
+
+    g_writeIndex++;
+}
+
 } // namespace FPS
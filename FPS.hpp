@@ -1,10 +1,21 @@
 #pragma once
 
-#include <atomic>
+#include <cstddef>
 
+// Frame time statistics
+// Game thread stores one timestamp per frame into a ring, logger thread
+// reads new ones every second and reports percentiles and hitches
 namespace FPS {
 
-void init( std::atomic< size_t >& _frameCount );
+// Frames the ring holds, logger has to read within this many frames
+inline constexpr const size_t g_capacity = 8192;
+// Frame is a hitch when it takes this many times the median
+inline constexpr const double g_hitchFactor = 2.0;
+
+void init();
 void quit();
 
+// Game thread, once per frame
+void frame();
+
 } // namespace FPS
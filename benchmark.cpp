@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <numbers>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "controls.hpp"
+#include "cull.hpp"
+#include "input.hpp"
+#include "job.hpp"
+#include "log.hpp"
+
+// Microbenchmarks of runtime hot paths
+//
+// Usage: benchmark
+namespace {
+
+inline constexpr const std::array< size_t, 3 > g_cullObjectCounts = {
+    10'000, 100'000, 1'000'000 };
+// Objects culled per object count, so every size runs long enough to measure
+inline constexpr const size_t g_cullTotalObjects = 100'000'000;
+
+inline constexpr const size_t g_controlsSamples = 10'000'000;
+// Every scancode is bound, every few keys are held
+inline constexpr const size_t g_controlsPressedStride = 7;
+
+// Players matched side by side, each with its own commands
+inline constexpr const size_t g_commandPlayers = 4;
+inline constexpr const size_t g_commandsPerPlayer = 256;
+// Key events per player, each changes input
+inline constexpr const size_t g_commandKeyEvents = 200'000;
+// 2 to g_maxSteps steps of random direction, last step also presses a button
+inline constexpr const size_t g_commandMinSteps = 2;
+inline constexpr const uint64_t g_commandWindowTicks = 300;
+
+// Binary task tree, every task spawns two children
+inline constexpr const size_t g_schedulerTreeDepth = 20;
+// Tasks spawned by one thread, then waited for
+inline constexpr const size_t g_schedulerFanOut = 1024;
+inline constexpr const size_t g_schedulerFanOutRounds = 1024;
+inline constexpr const size_t g_schedulerParallelForCount = 1'000'000;
+inline constexpr const size_t g_schedulerParallelForRounds = 64;
+
+// Deterministic input without <random>, its <cmath> clashes with log
+auto random( uint32_t& _state, float _minimum, float _maximum ) -> float {
+    // xorshift32
+    _state ^= ( _state << 13 );
+    _state ^= ( _state >> 17 );
+    _state ^= ( _state << 5 );
+
+    return ( _minimum + ( ( _maximum - _minimum ) *
+                          ( static_cast< float >( _state >> 8 ) /
+                            static_cast< float >( 1U << 24 ) ) ) );
+}
+
+void benchmarkCull() {
+    // 90 degrees both ways, looking down +Z from origin
+    const float l_diagonal = ( std::numbers::sqrt2_v< float > * 0.5F );
+
+    const cull::frustum_t l_frustum = { {
+        { l_diagonal, 0, l_diagonal, 0 },
+        { -l_diagonal, 0, l_diagonal, 0 },
+        { 0, l_diagonal, l_diagonal, 0 },
+        { 0, -l_diagonal, l_diagonal, 0 },
+        { 0, 0, 1, -0.1F },
+        { 0, 0, -1, 1000 },
+    } };
+
+    uint32_t l_state = 1;
+
+    std::vector< uint32_t > l_visible;
+
+    for ( const size_t l_objectCount : g_cullObjectCounts ) {
+        cull::bounds_t l_bounds;
+
+        l_bounds.resize( l_objectCount );
+
+        for ( size_t l_index = 0; l_index < l_objectCount; l_index++ ) {
+            l_bounds.set( l_index, { random( l_state, -1000.0F, 1000.0F ),
+                                     random( l_state, -1000.0F, 1000.0F ),
+                                     random( l_state, -1000.0F, 1000.0F ),
+                                     random( l_state, 0.1F, 10.0F ) } );
+        }
+
+        const size_t l_repeats = ( g_cullTotalObjects / l_objectCount );
+
+        // Warm up caches and visible list capacity
+        cull::visible( l_bounds, l_frustum, l_visible );
+
+        const auto l_start = std::chrono::steady_clock::now();
+
+        for ( size_t l_repeat = 0; l_repeat < l_repeats; l_repeat++ ) {
+            cull::visible( l_bounds, l_frustum, l_visible );
+        }
+
+        const std::chrono::duration< double, std::micro > l_elapsed =
+            ( std::chrono::steady_clock::now() - l_start );
+
+        log::info(
+            "Cull {:>9} objects: {:8.1f} objects/us, {:.3f} ms per pass, "
+            "{} visible",
+            l_objectCount,
+            ( static_cast< double >( l_objectCount * l_repeats ) /
+              l_elapsed.count() ),
+            ( ( l_elapsed.count() / static_cast< double >( l_repeats ) ) /
+              1000.0 ),
+            l_visible.size() );
+    }
+}
+
+void benchmarkControls() {
+    controls::table_t l_table;
+
+    for ( size_t l_scancode = 1; l_scancode < controls::g_scancodeCount;
+          l_scancode++ ) {
+        controls::input_t l_input;
+
+        l_input.direction = static_cast< controls::direction_t >(
+            1U << ( l_scancode % 4 ) );
+
+        l_table.bind( static_cast< SDL_Scancode >( l_scancode ), l_input );
+    }
+
+    std::array< bool, controls::g_scancodeCount > l_keys{};
+
+    for ( size_t l_scancode = 0; l_scancode < l_keys.size();
+          l_scancode += g_controlsPressedStride ) {
+        l_keys[ l_scancode ] = true;
+    }
+
+    uint8_t l_combined = 0;
+
+    const auto l_start = std::chrono::steady_clock::now();
+
+    for ( size_t l_sample = 0; l_sample < g_controlsSamples; l_sample++ ) {
+        // Keeps sample from being hoisted out of the loop
+        l_keys[ 0 ] = !!( l_sample & 1 );
+
+        l_combined |=
+            static_cast< uint8_t >( l_table.sample( l_keys ).direction );
+    }
+
+    const std::chrono::duration< double, std::nano > l_elapsed =
+        ( std::chrono::steady_clock::now() - l_start );
+
+    log::info(
+        "Controls {} bindings: {:.1f} ns per sample, directions {:#x}",
+        ( controls::g_scancodeCount - 1 ),
+        ( l_elapsed.count() / static_cast< double >( g_controlsSamples ) ),
+        l_combined );
+}
+
+// Index in [ 0, _count )
+auto randomIndex( uint32_t& _state, size_t _count ) -> size_t {
+    const auto l_index = static_cast< size_t >(
+        random( _state, 0, static_cast< float >( _count ) ) );
+
+    return ( std::min( l_index, ( _count - 1 ) ) );
+}
+
+void benchmarkCommands() {
+    using controls::button_t;
+    using controls::direction_t;
+
+    // Default bindings, arrows and four buttons
+    const controls::controls_t l_controls;
+    const controls::table_t l_table = controls::compile( l_controls );
+
+    const std::array< SDL_Scancode, 8 > l_scancodes = {
+        l_controls.up.scancode, l_controls.down.scancode,
+        l_controls.left.scancode, l_controls.right.scancode,
+        l_controls.a.scancode, l_controls.b.scancode,
+        l_controls.c.scancode, l_controls.d.scancode };
+
+    const std::array< direction_t, 9 > l_directions = {
+        direction_t::none,
+        direction_t::up,
+        direction_t::down,
+        direction_t::left,
+        direction_t::right,
+        ( direction_t::down | direction_t::left ),
+        ( direction_t::down | direction_t::right ),
+        ( direction_t::up | direction_t::left ),
+        ( direction_t::up | direction_t::right ) };
+
+    const std::array< button_t, 4 > l_buttons = {
+        button_t::a, button_t::b, button_t::c, button_t::d };
+
+    uint32_t l_state = 0x9E3779B9;
+
+    std::vector< input::player_t > l_players( g_commandPlayers );
+
+    for ( input::player_t& l_player : l_players ) {
+        l_player.table = &l_table;
+
+        for ( size_t l_index = 0; l_index < g_commandsPerPlayer; l_index++ ) {
+            input::command_t l_command;
+
+            l_command.stepCount =
+                ( g_commandMinSteps +
+                  randomIndex( l_state, ( input::g_maxSteps -
+                                          g_commandMinSteps + 1 ) ) );
+            l_command.windowTicks = g_commandWindowTicks;
+
+            for ( size_t l_step = 0; l_step < l_command.stepCount;
+                  l_step++ ) {
+                l_command.steps[ l_step ].direction =
+                    l_directions[ randomIndex( l_state,
+                                               l_directions.size() ) ];
+            }
+
+            l_command.steps[ l_command.stepCount - 1 ].button =
+                l_buttons[ randomIndex( l_state, l_buttons.size() ) ];
+
+            l_player.add( l_command );
+        }
+    }
+
+    // Generated up front, so only matching is measured
+    std::vector< std::pair< SDL_Scancode, bool > > l_events(
+        g_commandKeyEvents );
+    std::array< bool, 8 > l_isPressed{};
+
+    for ( auto& [ l_scancode, l_isDown ] : l_events ) {
+        const size_t l_key = randomIndex( l_state, l_scancodes.size() );
+
+        l_isPressed[ l_key ] = !l_isPressed[ l_key ];
+
+        l_scancode = l_scancodes[ l_key ];
+        l_isDown = l_isPressed[ l_key ];
+    }
+
+    size_t l_completed = 0;
+
+    const auto l_start = std::chrono::steady_clock::now();
+
+    for ( size_t l_event = 0; l_event < l_events.size(); l_event++ ) {
+        // Every event on its own tick, so every one is matched
+        const uint64_t l_timestamp =
+            ( ( l_event + 1 ) * 2 * input::g_tickNanoseconds );
+
+        for ( input::player_t& l_player : l_players ) {
+            l_player.key( l_events[ l_event ].first,
+                          l_events[ l_event ].second, l_timestamp );
+
+            l_completed += l_player.completed.size();
+
+            l_player.completed.clear();
+        }
+    }
+
+    const std::chrono::duration< double, std::nano > l_elapsed =
+        ( std::chrono::steady_clock::now() - l_start );
+
+    log::info( "Commands {} players x {}: {:.1f} ns per key event, {} "
+               "completed",
+               g_commandPlayers, g_commandsPerPlayer,
+               ( l_elapsed.count() /
+                 static_cast< double >( g_commandKeyEvents *
+                                        g_commandPlayers ) ),
+               l_completed );
+}
+
+void spawn( job::counter_t& _counter, size_t _depth ) {
+    if ( !_depth ) {
+        return;
+    }
+
+    for ( size_t l_child = 0; l_child < 2; l_child++ ) {
+        job::run(
+            [ &_counter, _depth ]() { spawn( _counter, ( _depth - 1 ) ); },
+            &_counter );
+    }
+}
+
+template < typename Function >
+void measureScheduler( std::string_view _name, Function&& _function ) {
+    job::resetStatistics();
+
+    const auto l_start = std::chrono::steady_clock::now();
+
+    _function();
+
+    const std::chrono::duration< double, std::micro > l_elapsed =
+        ( std::chrono::steady_clock::now() - l_start );
+
+    const job::statistics_t l_statistics = job::statistics();
+
+    log::info(
+        "Scheduler {:<12}: {:8.2f} tasks/us, {:>8} tasks, {:5.2f}% stolen, "
+        "{} contended steals, {} overflows, {} sleeps",
+        _name,
+        ( static_cast< double >( l_statistics.tasks ) / l_elapsed.count() ),
+        l_statistics.tasks,
+        ( ( 100.0 * static_cast< double >( l_statistics.steals ) ) /
+          static_cast< double >( std::max( l_statistics.tasks, 1UZ ) ) ),
+        l_statistics.failedSteals, l_statistics.overflows,
+        l_statistics.sleeps );
+}
+
+void benchmarkScheduler() {
+    if ( !job::init( std::max( std::thread::hardware_concurrency(), 1U ) -
+                     1 ) ) {
+        log::error( "Initializing job system" );
+
+        return;
+    }
+
+    // Work spreads only by stealing from the root thread
+    measureScheduler( "tree", [] {
+        job::counter_t l_counter = 0;
+
+        spawn( l_counter, g_schedulerTreeDepth );
+
+        job::wait( l_counter );
+    } );
+
+    // One producer, everyone else steals
+    measureScheduler( "fan out", [] {
+        std::atomic< size_t > l_sum = 0;
+
+        for ( size_t l_round = 0; l_round < g_schedulerFanOutRounds;
+              l_round++ ) {
+            job::counter_t l_counter = 0;
+
+            for ( size_t l_index = 0; l_index < g_schedulerFanOut;
+                  l_index++ ) {
+                job::run(
+                    [ &l_sum ]() {
+                        l_sum.fetch_add( 1, std::memory_order_relaxed );
+                    },
+                    &l_counter );
+            }
+
+            job::wait( l_counter );
+        }
+    } );
+
+    measureScheduler( "parallel for", [] {
+        std::vector< uint32_t > l_values( g_schedulerParallelForCount, 1 );
+
+        for ( size_t l_round = 0; l_round < g_schedulerParallelForRounds;
+              l_round++ ) {
+            job::parallelFor( l_values.size(), [ & ]( size_t _index ) {
+                l_values[ _index ] = ( ( l_values[ _index ] * 1664525U ) +
+                                       1013904223U );
+            } );
+        }
+    } );
+
+    job::quit();
+}
+
+} // namespace
+
+auto main() -> int {
+    benchmarkCull();
+
+    benchmarkControls();
+
+    benchmarkCommands();
+
+    benchmarkScheduler();
+
+    return ( EXIT_SUCCESS );
+}
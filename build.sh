@@ -4,7 +4,8 @@ clear
 set -e
 
 common_flags='-march=native -std=gnu++26 -ffunction-sections -fdata-sections -fPIC -fopenmp-simd -fno-short-enums -Wall -Wextra -Wno-gcc-compat -Wno-incompatible-pointer-types-discards-qualifiers -ggdb3 -fno-rtti -fno-exceptions -fno-threadsafe-statics -fno-unwind-tables'
-compiler_flags='-flto=jobserver -fno-ident -D DEBUG -D BX_CONFIG_DEBUG=1 -Og'
+# PROFILE=1 compiles profile scopes in, REPORT=1 counts allocations for --report
+compiler_flags="-flto=jobserver -fno-ident -D DEBUG -D BX_CONFIG_DEBUG=1${PROFILE:+ -D PROFILE}${REPORT:+ -D COUNT_ALLOCATIONS} -Og"
 linker_flags=" -flto -fuse-ld=mold -Wl,-O1 -Wl,--gc-sections -Wl,--no-eh-frame-hdr -rdynamic -Wl,-rpath,\$ORIGIN"
 glsl_version=120
 
@@ -14,32 +15,71 @@ fragment_filename='fs'
 vertex_filepath="$vertex_filename"'.vert'
 fragment_filepath="$fragment_filename"'.frag'
 vertex_compiled_filepath="$vertex_filename"'.bin'
+quantized_vertex_compiled_filepath="$vertex_filename"'_quantized.bin'
+instanced_vertex_compiled_filepath="$vertex_filename"'_instanced.bin'
+quantized_instanced_vertex_compiled_filepath="$vertex_filename"'_quantized_instanced.bin'
 fragment_compiled_filepath="$fragment_filename"'.bin'
 
 compile_shader() {
     input="$1"
     output="$2"
     type="$3"
+    defines="$4"
 
     if [ ! -f "$output" ] || [[ "$input" -nt "$output" ]]; then
-        shaderc -f "$input" -o "$output" --type "$type" --platform linux --profile "$glsl_version"
+        shaderc -f "$input" -o "$output" --type "$type" --platform linux --profile "$glsl_version" ${defines:+--define "$defines"}
 
         echo 'Making '"$output"
     fi
 }
 
 compile_shader "$vertex_filepath" "$vertex_compiled_filepath" 'vertex'
+compile_shader "$vertex_filepath" "$quantized_vertex_compiled_filepath" 'vertex' 'QUANTIZED'
+compile_shader "$vertex_filepath" "$instanced_vertex_compiled_filepath" 'vertex' 'INSTANCED'
+compile_shader "$vertex_filepath" "$quantized_instanced_vertex_compiled_filepath" 'vertex' 'QUANTIZED;INSTANCED'
 compile_shader "$fragment_filepath" "$fragment_compiled_filepath" 'fragment'
 
 source_files=(
     'FPS.cpp'
+    'controls.cpp'
+    'cull.cpp'
+    'draw.cpp'
+    'governor.cpp'
+    'input.cpp'
+    'job.cpp'
+    'log.cpp'
     'main.cpp'
+    'mesh.cpp'
+    'profile.cpp'
+    'replay.cpp'
+    'report.cpp'
     'runtime.cpp'
     'shader.cpp'
+    'stream.cpp'
+    'texture.cpp'
+    'timestep.cpp'
     'vsync.cpp'
 )
 
-for source_file in "${source_files[@]}"; do
+cooker_source_files=(
+    'compress.cpp'
+    'cooker.cpp'
+    'log.cpp'
+    'optimize.cpp'
+    'quantize.cpp'
+    'simplify.cpp'
+)
+
+benchmark_source_files=(
+    'benchmark.cpp'
+    'controls.cpp'
+    'cull.cpp'
+    'input.cpp'
+    'job.cpp'
+    'log.cpp'
+)
+
+for source_file in $(printf '%s\n' "${source_files[@]}" "${cooker_source_files[@]}" "${benchmark_source_files[@]}" | sort -u); do
     echo 'Making '"$source_file"
 
     bear -- ccache clang++ $common_flags $compiler_flags -c "$source_file"
@@ -47,4 +87,25 @@ done
 
 echo 'Making executable'
 
-clang++ $common_flags $linker_flags ${source_files[@]/%.cpp/.o} -lSDL3 -lbgfx -lassimp -lmimalloc -lelf -lunwind
+clang++ $common_flags $linker_flags ${source_files[@]/%.cpp/.o} -lSDL3 -lbgfx -lmimalloc -lelf -lunwind
+
+echo 'Making cooker'
+
+clang++ $common_flags $linker_flags ${cooker_source_files[@]/%.cpp/.o} -o cooker -lassimp -lmimalloc
+
+echo 'Making benchmark'
+
+clang++ $common_flags $linker_flags ${benchmark_source_files[@]/%.cpp/.o} -o benchmark -lmimalloc
+
+cook_model() {
+    input="$1"
+    output="$2"
+
+    if [ -f "$input" ] && { [ ! -f "$output" ] || [[ "$input" -nt "$output" ]]; }; then
+        ./cooker --quantize "$input" "$output"
+
+        echo 'Making '"$output"
+    fi
+}
+
+cook_model 't.fbx' 't.mesh'
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 namespace camera {
 
 // TODO: Implement
@@ -10,6 +12,13 @@ using camera_t = struct camera {
     ~camera() = default;
     auto operator=( const camera& ) -> camera& = default;
     auto operator=( camera&& ) -> camera& = default;
+
+    std::array< float, 3 > position = { 0, 0, -5 };
+    std::array< float, 3 > target = { 0, 0, 0 };
+    // Vertical, in degrees
+    float fieldOfView = 60;
+    float near = 0.1F;
+    float far = 100;
 };
 
 } // namespace camera
@@ -1,19 +1,81 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 // Function-like macros
 // Universal
 #define STRINGIFY( _value ) #_value
 #define MACRO_TO_STRING( _macro ) STRINGIFY( _macro )
+#define _CONCAT( _first, _second ) _first##_second
+#define CONCAT( _first, _second ) _CONCAT( _first, _second )
 
 // Constants
 // Universal
 static inline constexpr const size_t g_oneSecondInMilliseconds = 1000;
 static inline constexpr const size_t g_oneMillisecondInNanoseconds = 1000000;
+static inline constexpr const size_t g_cacheLineSize = 64;
 
 template < typename T >
 static inline constexpr auto millisecondsToNanoseconds( const T _milliseconds )
     -> size_t {
     return ( _milliseconds * g_oneMillisecondInNanoseconds );
 }
+
+// Milliseconds
+using timeSummary_t = struct timeSummary {
+    timeSummary() = default;
+    timeSummary( const timeSummary& ) = default;
+    timeSummary( timeSummary&& ) = default;
+    ~timeSummary() = default;
+    auto operator=( const timeSummary& ) -> timeSummary& = default;
+    auto operator=( timeSummary&& ) -> timeSummary& = default;
+
+    double total = 0;
+    double min = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+// Sorts nanosecond times, percentiles are nearest rank
+static inline auto summarize( std::vector< int64_t >& _times )
+    -> timeSummary_t {
+    timeSummary_t l_returnValue;
+
+    if ( _times.empty() ) {
+        return ( l_returnValue );
+    }
+
+    std::ranges::sort( _times );
+
+    auto l_percentile = [ & ]( size_t _percent ) -> double {
+        const size_t l_rank = ( ( ( _times.size() - 1 ) * _percent ) / 100 );
+
+        return ( static_cast< double >( _times[ l_rank ] ) /
+                 static_cast< double >( g_oneMillisecondInNanoseconds ) );
+    };
+
+    int64_t l_total = 0;
+
+    for ( const int64_t l_time : _times ) {
+        l_total += l_time;
+    }
+
+    l_returnValue.total =
+        ( static_cast< double >( l_total ) /
+          static_cast< double >( g_oneMillisecondInNanoseconds ) );
+    l_returnValue.min = l_percentile( 0 );
+    l_returnValue.mean =
+        ( l_returnValue.total / static_cast< double >( _times.size() ) );
+    l_returnValue.p50 = l_percentile( 50 );
+    l_returnValue.p95 = l_percentile( 95 );
+    l_returnValue.p99 = l_percentile( 99 );
+    l_returnValue.max = l_percentile( 100 );
+
+    return ( l_returnValue );
+}
@@ -0,0 +1,373 @@
+#include "compress.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <limits>
+
+#include "log.hpp"
+
+namespace compress {
+
+namespace {
+
+// DDS constants
+inline constexpr const uint32_t g_ddsMagic = 0x20534444;
+inline constexpr const uint32_t g_ddsHeaderSize = 124;
+inline constexpr const uint32_t g_ddsPixelFormatSize = 32;
+inline constexpr const uint32_t g_ddsFlags =
+    ( 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000 );
+inline constexpr const uint32_t g_ddsPixelFormatFourCC = 0x4;
+inline constexpr const uint32_t g_ddsCaps = ( 0x8 | 0x1000 | 0x400000 );
+inline constexpr const uint32_t g_fourCCDXT1 = 0x31545844;
+inline constexpr const uint32_t g_fourCCDXT5 = 0x35545844;
+
+inline constexpr const size_t g_blockSize = 4;
+
+using ddsHeader_t = struct ddsHeader {
+    uint32_t magic = g_ddsMagic;
+    uint32_t size = g_ddsHeaderSize;
+    uint32_t flags = g_ddsFlags;
+    uint32_t height = 0;
+    uint32_t width = 0;
+    uint32_t pitchOrLinearSize = 0;
+    uint32_t depth = 0;
+    uint32_t mipMapCount = 0;
+    std::array< uint32_t, 11 > reserved1{};
+    uint32_t pixelFormatSize = g_ddsPixelFormatSize;
+    uint32_t pixelFormatFlags = g_ddsPixelFormatFourCC;
+    uint32_t fourCC = 0;
+    std::array< uint32_t, 5 > pixelFormatMasks{};
+    uint32_t caps = g_ddsCaps;
+    std::array< uint32_t, 3 > caps2To4{};
+    uint32_t reserved2 = 0;
+};
+
+static_assert( sizeof( ddsHeader_t ) == ( sizeof( uint32_t ) + 124 ) );
+
+using image_t = struct image {
+    image() = default;
+    image( const image& ) = default;
+    image( image&& ) = default;
+    ~image() = default;
+    auto operator=( const image& ) -> image& = default;
+    auto operator=( image&& ) -> image& = default;
+
+    [[nodiscard]] auto texel( uint32_t _x, uint32_t _y ) const
+        -> const uint8_t* {
+        _x = std::min( _x, ( width - 1 ) );
+        _y = std::min( _y, ( height - 1 ) );
+
+        return ( &pixels[ ( ( _y * width ) + _x ) * 4 ] );
+    }
+
+    std::vector< uint8_t > pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// 4x4 RGBA texels
+using block_t = std::array< std::array< int, 4 >, 16 >;
+
+template < typename T >
+void append( std::vector< std::byte >& _output, const T& _value ) {
+    const auto l_bytes = std::as_bytes( std::span( &_value, 1 ) );
+
+    _output.insert( _output.end(), l_bytes.begin(), l_bytes.end() );
+}
+
+// 2x2 box filter, odd edges are clamped
+auto downsample( const image_t& _source ) -> image_t {
+    image_t l_returnValue;
+
+    l_returnValue.width = std::max( ( _source.width / 2 ), 1U );
+    l_returnValue.height = std::max( ( _source.height / 2 ), 1U );
+    l_returnValue.pixels.resize( l_returnValue.width * l_returnValue.height *
+                                 4 );
+
+    for ( uint32_t l_y = 0; l_y < l_returnValue.height; l_y++ ) {
+        for ( uint32_t l_x = 0; l_x < l_returnValue.width; l_x++ ) {
+            const uint8_t* l_texels[] = {
+                _source.texel( ( l_x * 2 ), ( l_y * 2 ) ),
+                _source.texel( ( ( l_x * 2 ) + 1 ), ( l_y * 2 ) ),
+                _source.texel( ( l_x * 2 ), ( ( l_y * 2 ) + 1 ) ),
+                _source.texel( ( ( l_x * 2 ) + 1 ), ( ( l_y * 2 ) + 1 ) ),
+            };
+
+            uint8_t* l_output = &l_returnValue.pixels[ (
+                ( ( l_y * l_returnValue.width ) + l_x ) * 4 ) ];
+
+            for ( size_t l_channel = 0; l_channel < 4; l_channel++ ) {
+                l_output[ l_channel ] = static_cast< uint8_t >(
+                    ( l_texels[ 0 ][ l_channel ] + l_texels[ 1 ][ l_channel ] +
+                      l_texels[ 2 ][ l_channel ] + l_texels[ 3 ][ l_channel ] +
+                      2 ) /
+                    4 );
+            }
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto to565( const std::array< int, 4 >& _color ) -> uint16_t {
+    const int l_red = ( ( ( _color[ 0 ] * 31 ) + 127 ) / 255 );
+    const int l_green = ( ( ( _color[ 1 ] * 63 ) + 127 ) / 255 );
+    const int l_blue = ( ( ( _color[ 2 ] * 31 ) + 127 ) / 255 );
+
+    return ( static_cast< uint16_t >( ( l_red << 11 ) | ( l_green << 5 ) |
+                                      l_blue ) );
+}
+
+auto from565( const uint16_t _color ) -> std::array< int, 4 > {
+    const int l_red = ( ( _color >> 11 ) & 0x1F );
+    const int l_green = ( ( _color >> 5 ) & 0x3F );
+    const int l_blue = ( _color & 0x1F );
+
+    return ( std::array< int, 4 >{ ( ( l_red << 3 ) | ( l_red >> 2 ) ),
+                                   ( ( l_green << 2 ) | ( l_green >> 4 ) ),
+                                   ( ( l_blue << 3 ) | ( l_blue >> 2 ) ),
+                                   0xFF } );
+}
+
+// Bounding box endpoints, always 4 color mode
+void encodeColor( const block_t& _block, std::vector< std::byte >& _output ) {
+    std::array< int, 4 > l_minimum = { 255, 255, 255, 255 };
+    std::array< int, 4 > l_maximum = { 0, 0, 0, 0 };
+
+    for ( const auto& l_texel : _block ) {
+        for ( size_t l_channel = 0; l_channel < 3; l_channel++ ) {
+            l_minimum[ l_channel ] =
+                std::min( l_minimum[ l_channel ], l_texel[ l_channel ] );
+            l_maximum[ l_channel ] =
+                std::max( l_maximum[ l_channel ], l_texel[ l_channel ] );
+        }
+    }
+
+    // Inset by 1/16 of the range to lower error on the endpoints
+    for ( size_t l_channel = 0; l_channel < 3; l_channel++ ) {
+        const int l_inset =
+            ( ( l_maximum[ l_channel ] - l_minimum[ l_channel ] ) >> 4 );
+
+        l_minimum[ l_channel ] += l_inset;
+        l_maximum[ l_channel ] -= l_inset;
+    }
+
+    uint16_t l_color0 = to565( l_maximum );
+    uint16_t l_color1 = to565( l_minimum );
+    uint32_t l_indices = 0;
+
+    if ( l_color0 < l_color1 ) {
+        std::swap( l_color0, l_color1 );
+    }
+
+    // Otherwise every index stays 0
+    if ( l_color0 != l_color1 ) {
+        const std::array< int, 4 > l_end0 = from565( l_color0 );
+        const std::array< int, 4 > l_end1 = from565( l_color1 );
+
+        std::array< std::array< int, 4 >, 4 > l_palette{};
+
+        l_palette[ 0 ] = l_end0;
+        l_palette[ 1 ] = l_end1;
+
+        for ( size_t l_channel = 0; l_channel < 3; l_channel++ ) {
+            l_palette[ 2 ][ l_channel ] =
+                ( ( ( 2 * l_end0[ l_channel ] ) + l_end1[ l_channel ] ) / 3 );
+            l_palette[ 3 ][ l_channel ] =
+                ( ( l_end0[ l_channel ] + ( 2 * l_end1[ l_channel ] ) ) / 3 );
+        }
+
+        for ( size_t l_texelIndex = 0; l_texelIndex < _block.size();
+              l_texelIndex++ ) {
+            const auto& l_texel = _block[ l_texelIndex ];
+
+            uint32_t l_bestIndex = 0;
+            int l_bestDistance = std::numeric_limits< int >::max();
+
+            for ( uint32_t l_paletteIndex = 0; l_paletteIndex < 4;
+                  l_paletteIndex++ ) {
+                int l_distance = 0;
+
+                for ( size_t l_channel = 0; l_channel < 3; l_channel++ ) {
+                    const int l_delta =
+                        ( l_texel[ l_channel ] -
+                          l_palette[ l_paletteIndex ][ l_channel ] );
+
+                    l_distance += ( l_delta * l_delta );
+                }
+
+                if ( l_distance < l_bestDistance ) {
+                    l_bestDistance = l_distance;
+                    l_bestIndex = l_paletteIndex;
+                }
+            }
+
+            l_indices |= ( l_bestIndex << ( l_texelIndex * 2 ) );
+        }
+    }
+
+    append( _output, l_color0 );
+    append( _output, l_color1 );
+    append( _output, l_indices );
+}
+
+// 8 alpha mode between block minimum and maximum
+void encodeAlpha( const block_t& _block, std::vector< std::byte >& _output ) {
+    int l_minimum = 255;
+    int l_maximum = 0;
+
+    for ( const auto& l_texel : _block ) {
+        l_minimum = std::min( l_minimum, l_texel[ 3 ] );
+        l_maximum = std::max( l_maximum, l_texel[ 3 ] );
+    }
+
+    uint64_t l_indices = 0;
+
+    if ( l_maximum != l_minimum ) {
+        std::array< int, 8 > l_palette{};
+
+        l_palette[ 0 ] = l_maximum;
+        l_palette[ 1 ] = l_minimum;
+
+        for ( int l_step = 1; l_step < 7; l_step++ ) {
+            l_palette[ l_step + 1 ] =
+                ( ( ( ( 7 - l_step ) * l_maximum ) + ( l_step * l_minimum ) ) /
+                  7 );
+        }
+
+        for ( size_t l_texelIndex = 0; l_texelIndex < _block.size();
+              l_texelIndex++ ) {
+            uint64_t l_bestIndex = 0;
+            int l_bestDistance = std::numeric_limits< int >::max();
+
+            for ( uint64_t l_paletteIndex = 0; l_paletteIndex < 8;
+                  l_paletteIndex++ ) {
+                const int l_distance = std::abs(
+                    _block[ l_texelIndex ][ 3 ] - l_palette[ l_paletteIndex ] );
+
+                if ( l_distance < l_bestDistance ) {
+                    l_bestDistance = l_distance;
+                    l_bestIndex = l_paletteIndex;
+                }
+            }
+
+            l_indices |= ( l_bestIndex << ( l_texelIndex * 3 ) );
+        }
+    }
+
+    append( _output, static_cast< uint8_t >( l_maximum ) );
+    append( _output, static_cast< uint8_t >( l_minimum ) );
+
+    // 48 bits of indices
+    for ( size_t l_byte = 0; l_byte < 6; l_byte++ ) {
+        append( _output,
+                static_cast< uint8_t >( ( l_indices >> ( l_byte * 8 ) ) &
+                                        0xFF ) );
+    }
+}
+
+void encode( const image_t& _image,
+             format_t _format,
+             std::vector< std::byte >& _output ) {
+    for ( uint32_t l_blockY = 0; l_blockY < _image.height;
+          l_blockY += g_blockSize ) {
+        for ( uint32_t l_blockX = 0; l_blockX < _image.width;
+              l_blockX += g_blockSize ) {
+            block_t l_block{};
+
+            for ( uint32_t l_y = 0; l_y < g_blockSize; l_y++ ) {
+                for ( uint32_t l_x = 0; l_x < g_blockSize; l_x++ ) {
+                    const uint8_t* l_texel =
+                        _image.texel( ( l_blockX + l_x ), ( l_blockY + l_y ) );
+
+                    std::ranges::copy( std::span( l_texel, 4 ),
+                                       l_block[ ( l_y * g_blockSize ) + l_x ]
+                                           .begin() );
+                }
+            }
+
+            if ( _format == format_t::bc3 ) {
+                encodeAlpha( l_block, _output );
+            }
+
+            encodeColor( l_block, _output );
+        }
+    }
+}
+
+} // namespace
+
+auto pickFormat( std::span< const uint8_t > _rgba ) -> format_t {
+    format_t l_returnValue = format_t::bc1;
+
+    for ( size_t l_index = 3; l_index < _rgba.size(); l_index += 4 ) {
+        if ( _rgba[ l_index ] != 0xFF ) {
+            l_returnValue = format_t::bc3;
+
+            break;
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto toDDS( std::span< const uint8_t > _rgba,
+            uint32_t _width,
+            uint32_t _height,
+            format_t _format,
+            std::vector< std::byte >& _dds ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        if ( !_width || !_height ||
+             ( _rgba.size() != ( static_cast< size_t >( _width ) * _height *
+                                 4 ) ) ) {
+            log::error( "Wrong image size" );
+
+            goto EXIT;
+        }
+
+        const size_t l_bytesPerBlock =
+            ( ( _format == format_t::bc1 ) ? ( 8 ) : ( 16 ) );
+
+        ddsHeader_t l_header;
+
+        l_header.width = _width;
+        l_header.height = _height;
+        l_header.mipMapCount =
+            ( std::bit_width( std::max( _width, _height ) ) );
+        l_header.pitchOrLinearSize =
+            ( ( ( _width + 3 ) / 4 ) * ( ( _height + 3 ) / 4 ) *
+              l_bytesPerBlock );
+        l_header.fourCC = ( ( _format == format_t::bc1 ) ? ( g_fourCCDXT1 )
+                                                         : ( g_fourCCDXT5 ) );
+
+        _dds.clear();
+
+        append( _dds, l_header );
+
+        image_t l_mip;
+
+        l_mip.pixels.assign( _rgba.begin(), _rgba.end() );
+        l_mip.width = _width;
+        l_mip.height = _height;
+
+        for ( uint32_t l_level = 0; l_level < l_header.mipMapCount;
+              l_level++ ) {
+            if ( l_level ) {
+                l_mip = downsample( l_mip );
+            }
+
+            encode( l_mip, _format, _dds );
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace compress
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// CPU block compression for offline cooking
+namespace compress {
+
+enum class format_t : uint8_t {
+    // Opaque RGB, 4 bits per texel
+    bc1 = 0,
+    // RGB with interpolated alpha, 8 bits per texel
+    bc3,
+};
+
+// BC1 if every texel is opaque, otherwise BC3
+auto pickFormat( std::span< const uint8_t > _rgba ) -> format_t;
+
+// Builds full mip chain and writes it block compressed into DDS container
+auto toDDS( std::span< const uint8_t > _rgba,
+            uint32_t _width,
+            uint32_t _height,
+            format_t _format,
+            std::vector< std::byte >& _dds ) -> bool;
+
+} // namespace compress
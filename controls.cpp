@@ -0,0 +1,86 @@
+#include "controls.hpp"
+
+#include <bit>
+
+#if defined( __AVX2__ )
+
+#include <immintrin.h>
+
+#endif
+
+namespace controls {
+
+void table_t::bind( SDL_Scancode _scancode, const input_t& _input ) {
+    const auto l_scancode = static_cast< size_t >( _scancode );
+
+    if ( ( _scancode == SDL_SCANCODE_UNKNOWN ) ||
+         ( l_scancode >= g_scancodeCount ) ) {
+        return;
+    }
+
+    directions[ l_scancode ] |= _input.direction;
+    buttons[ l_scancode ] |= _input.button;
+    bound[ l_scancode / g_width ] |= ( 1U << ( l_scancode % g_width ) );
+}
+
+auto table_t::sample( keys_t _keys ) const -> input_t {
+    input_t l_returnValue;
+
+    for ( size_t l_word = 0; l_word < bound.size(); l_word++ ) {
+        const size_t l_first = ( l_word * g_width );
+        uint32_t l_mask = bound[ l_word ];
+
+        if ( !l_mask ) {
+            continue;
+        }
+
+#if defined( __AVX2__ )
+
+        const __m256i l_keys = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( _keys.data() + l_first ) );
+
+        // Released keys are zero bytes
+        l_mask &= ~static_cast< uint32_t >( _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8( l_keys, _mm256_setzero_si256() ) ) );
+
+#else
+
+        uint32_t l_pressed = 0;
+
+        for ( uint32_t l_bits = l_mask; l_bits; l_bits &= ( l_bits - 1 ) ) {
+            const int l_lane = std::countr_zero( l_bits );
+
+            l_pressed |= ( static_cast< uint32_t >( _keys[ l_first + l_lane ] )
+                           << l_lane );
+        }
+
+        l_mask = l_pressed;
+
+#endif
+
+        while ( l_mask ) {
+            const size_t l_scancode = ( l_first + std::countr_zero( l_mask ) );
+
+            l_returnValue.direction |= directions[ l_scancode ];
+            l_returnValue.button |= buttons[ l_scancode ];
+
+            l_mask &= ( l_mask - 1 );
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto compile( const controls_t& _controls ) -> table_t {
+    table_t l_returnValue;
+
+    for ( const control_t& l_control :
+          { _controls.up, _controls.down, _controls.left, _controls.right,
+            _controls.a, _controls.b, _controls.c, _controls.d } ) {
+        l_returnValue.bind( l_control.scancode, l_control.input );
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace controls
@@ -2,7 +2,10 @@
 
 #include <SDL3/SDL.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string_view>
 #include <type_traits>
 
@@ -54,6 +57,10 @@ inline constexpr auto operator&( direction_t _lhs, direction_t _rhs )
 
 enum class button_t : uint8_t {
     none = 0,
+    a = 0b1,
+    b = 0b10,
+    c = 0b100,
+    d = 0b1000,
 };
 
 inline constexpr auto operator|=( button_t& _lhs, button_t _rhs ) -> button_t& {
@@ -89,6 +96,7 @@ using input_t = struct input {
 
     direction_t direction = direction_t::none;
     button_t button = button_t::none;
+    // Ticks held, in input history
     size_t duration = 0;
 };
 
@@ -108,6 +116,18 @@ using control_t = struct control {
     input_t input;
 };
 
+inline auto binding( SDL_Scancode _scancode,
+                     direction_t _direction,
+                     button_t _button = button_t::none ) -> control_t {
+    control_t l_returnValue;
+
+    l_returnValue.scancode = _scancode;
+    l_returnValue.input.direction = _direction;
+    l_returnValue.input.button = _button;
+
+    return ( l_returnValue );
+}
+
 // All available controls
 using controls_t = struct controls {
     controls() = default;
@@ -117,29 +137,51 @@ using controls_t = struct controls {
     auto operator=( const controls& ) -> controls& = default;
     auto operator=( controls&& ) -> controls& = default;
 
-    inline constexpr auto get( const SDL_Scancode _scancode )
-        -> const control_t {
-        if ( up.check( _scancode ) ) {
-            return ( up );
+    // Directions
+    control_t up = binding( SDL_SCANCODE_UP, direction_t::up );
+    control_t down = binding( SDL_SCANCODE_DOWN, direction_t::down );
+    control_t left = binding( SDL_SCANCODE_LEFT, direction_t::left );
+    control_t right = binding( SDL_SCANCODE_RIGHT, direction_t::right );
+
+    // Buttons
+    control_t a = binding( SDL_SCANCODE_Z, direction_t::none, button_t::a );
+    control_t b = binding( SDL_SCANCODE_X, direction_t::none, button_t::b );
+    control_t c = binding( SDL_SCANCODE_C, direction_t::none, button_t::c );
+    control_t d = binding( SDL_SCANCODE_V, direction_t::none, button_t::d );
+};
 
-        } else if ( down.check( _scancode ) ) {
-            return ( down );
+inline constexpr const size_t g_scancodeCount = SDL_SCANCODE_COUNT;
+// Keys tested per iteration, one AVX2 register of bytes
+inline constexpr const size_t g_width = 32;
 
-        } else if ( left.check( _scancode ) ) {
-            return ( left );
+static_assert( !( g_scancodeCount % g_width ),
+               "Scancodes do not fill whole registers" );
 
-        } else if ( right.check( _scancode ) ) {
-            return ( right );
-        }
+// SDL_GetKeyboardState
+using keys_t = std::span< const bool, g_scancodeCount >;
 
-        return {};
-    }
+// Bindings indexed by scancode
+// Compiled from controls_t, compile again after bindings changed
+using table_t = struct table {
+    table() = default;
+    table( const table& ) = default;
+    table( table&& ) = default;
+    ~table() = default;
+    auto operator=( const table& ) -> table& = default;
+    auto operator=( table&& ) -> table& = default;
 
-    // Directions
-    control_t up;
-    control_t down;
-    control_t left;
-    control_t right;
+    // Adds to whatever _scancode is bound to already
+    void bind( SDL_Scancode _scancode, const input_t& _input );
+
+    // Combined input of pressed bound keys, unbound keys are never read
+    auto sample( keys_t _keys ) const -> input_t;
+
+    std::array< direction_t, g_scancodeCount > directions{};
+    std::array< button_t, g_scancodeCount > buttons{};
+    // Bit per scancode, word per g_width scancodes
+    std::array< uint32_t, ( g_scancodeCount / g_width ) > bound{};
 };
 
+auto compile( const controls_t& _controls ) -> table_t;
+
 } // namespace controls
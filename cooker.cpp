@@ -0,0 +1,685 @@
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "compress.hpp"
+#include "log.hpp"
+#include "mesh.hpp"
+#include "optimize.hpp"
+#include "quantize.hpp"
+#include "simplify.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+// Offline mesh cooker
+// Textures are written next to output mesh as "<output mesh>.N.dds"
+//
+// Usage: cooker [--quantize] <input model> <output mesh>
+// --quantize stores meshes in compact layout where precision allows
+namespace {
+
+// Every level aims at half of the triangles of the previous one
+inline constexpr const float g_lodReduction = 0.5F;
+// Level that removes less than this fraction is not worth storing
+inline constexpr const float g_lodMinReduction = 0.2F;
+// Deviation bound of any level, relative to bounding radius
+inline constexpr const float g_lodMaxError = 0.05F;
+
+using cookedMesh_t = struct cookedMesh {
+    cookedMesh() = default;
+    cookedMesh( const cookedMesh& ) = default;
+    cookedMesh( cookedMesh&& ) = default;
+    ~cookedMesh() = default;
+    auto operator=( const cookedMesh& ) -> cookedMesh& = default;
+    auto operator=( cookedMesh&& ) -> cookedMesh& = default;
+
+    // Raw bytes of whichever layout is written
+    [[nodiscard]] auto vertexData() const -> std::span< const std::byte > {
+        return ( quantizedVertices.empty()
+                     ? ( std::as_bytes( std::span( vertices ) ) )
+                     : ( std::as_bytes( std::span( quantizedVertices ) ) ) );
+    }
+
+    std::vector< mesh::vertex_t > vertices;
+    // Non empty if mesh is stored quantized
+    std::vector< mesh::quantizedVertex_t > quantizedVertices;
+    std::array< float, 4 > positionScale = { 1, 1, 1, 0 };
+    std::array< float, 4 > positionBias{};
+    // All levels of detail, finest first
+    std::vector< mesh::index_t > indices;
+    std::vector< mesh::lod_t > lods;
+    std::array< float, 4 > bounds{};
+    std::string texture;
+};
+
+using cookedTexture_t = struct cookedTexture {
+    cookedTexture() = default;
+    cookedTexture( const cookedTexture& ) = default;
+    cookedTexture( cookedTexture&& ) = default;
+    ~cookedTexture() = default;
+    auto operator=( const cookedTexture& ) -> cookedTexture& = default;
+    auto operator=( cookedTexture&& ) -> cookedTexture& = default;
+
+    std::vector< std::byte > data;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::string hint;
+};
+
+auto cook( const aiTexture& _texture, cookedTexture_t& _cooked ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        if ( !_texture.mWidth ) {
+            log::warning( "Texture is empty" );
+
+            goto EXIT;
+        }
+
+        // Encoded image of mWidth bytes
+        if ( !_texture.mHeight ) {
+            const auto l_data = std::span(
+                reinterpret_cast< const std::byte* >( _texture.pcData ),
+                _texture.mWidth );
+
+            _cooked.data.assign( l_data.begin(), l_data.end() );
+            _cooked.hint = std::string_view( _texture.achFormatHint );
+
+            if ( _cooked.hint.size() >= mesh::g_textureHintLength ) {
+                _cooked.hint.clear();
+            }
+
+        } else {
+            // Raw BGRA texels, stored as RGBA8
+            const auto l_texels = std::span(
+                _texture.pcData, ( _texture.mWidth * _texture.mHeight ) );
+
+            _cooked.data.reserve( l_texels.size() * 4 );
+
+            for ( const aiTexel& l_texel : l_texels ) {
+                _cooked.data.push_back( std::byte{ l_texel.r } );
+                _cooked.data.push_back( std::byte{ l_texel.g } );
+                _cooked.data.push_back( std::byte{ l_texel.b } );
+                _cooked.data.push_back( std::byte{ l_texel.a } );
+            }
+
+            _cooked.width = _texture.mWidth;
+            _cooked.height = _texture.mHeight;
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+auto cook( const aiScene& _scene, const aiMesh& _mesh, cookedMesh_t& _cooked )
+    -> bool {
+    bool l_returnValue = false;
+
+    {
+        if ( !_mesh.HasPositions() ) {
+            log::warning( "Mesh has no positions" );
+
+            goto EXIT;
+        }
+
+        _cooked.vertices.reserve( _mesh.mNumVertices );
+
+        for ( unsigned l_index = 0; l_index < _mesh.mNumVertices; l_index++ ) {
+            mesh::vertex_t l_vertex{};
+
+            l_vertex.x = _mesh.mVertices[ l_index ].x;
+            l_vertex.y = _mesh.mVertices[ l_index ].y;
+            l_vertex.z = _mesh.mVertices[ l_index ].z;
+
+            if ( _mesh.HasNormals() ) {
+                l_vertex.nx = _mesh.mNormals[ l_index ].x;
+                l_vertex.ny = _mesh.mNormals[ l_index ].y;
+                l_vertex.nz = _mesh.mNormals[ l_index ].z;
+            }
+
+            if ( _mesh.HasTextureCoords( 0 ) ) {
+                l_vertex.u = _mesh.mTextureCoords[ 0 ][ l_index ].x;
+                l_vertex.v = _mesh.mTextureCoords[ 0 ][ l_index ].y;
+            }
+
+            _cooked.vertices.push_back( l_vertex );
+        }
+
+        _cooked.indices.reserve( _mesh.mNumFaces * 3 );
+
+        for ( unsigned l_index = 0; l_index < _mesh.mNumFaces; l_index++ ) {
+            const aiFace& l_face = _mesh.mFaces[ l_index ];
+
+            // Points and lines are left after triangulation
+            if ( l_face.mNumIndices != 3 ) {
+                continue;
+            }
+
+            _cooked.indices.push_back( l_face.mIndices[ 0 ] );
+            _cooked.indices.push_back( l_face.mIndices[ 1 ] );
+            _cooked.indices.push_back( l_face.mIndices[ 2 ] );
+        }
+
+        if ( _cooked.vertices.empty() || _cooked.indices.empty() ) {
+            log::warning( "Mesh has empty vertices or indices" );
+
+            goto EXIT;
+        }
+
+        // Diffuse texture
+        if ( _scene.HasMaterials() ) {
+            const aiMaterial* l_material =
+                _scene.mMaterials[ _mesh.mMaterialIndex ];
+
+            aiString l_texturePath;
+
+            if ( l_material &&
+                 ( l_material->GetTextureCount( aiTextureType_DIFFUSE ) > 0 ) &&
+                 ( l_material->GetTexture( aiTextureType_DIFFUSE, 0,
+                                           &l_texturePath ) == AI_SUCCESS ) ) {
+                _cooked.texture = l_texturePath.C_Str();
+            }
+        }
+
+        // Single embedded texture use case
+        if ( _cooked.texture.empty() && ( _scene.mNumTextures > 0 ) ) {
+            _cooked.texture = "*0";
+        }
+
+        if ( _cooked.texture.size() >= mesh::g_textureNameLength ) {
+            log::warning( "Texture name is too long: '{}'", _cooked.texture );
+
+            _cooked.texture.clear();
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+// Decodes disk or embedded texture, block compresses it with full mip chain
+auto compressTexture( const std::string_view _name,
+                      std::span< const cookedTexture_t > _embedded,
+                      const std::string_view _path ) -> bool {
+    bool l_returnValue = false;
+
+    stbi_uc* l_pixels = nullptr;
+
+    {
+        int l_width = 0;
+        int l_height = 0;
+        int l_channels = 0;
+
+        if ( _name.starts_with( '*' ) ) {
+            size_t l_index = 0;
+
+            const auto [ l_end, l_error ] = std::from_chars(
+                ( _name.data() + 1 ), ( _name.data() + _name.size() ),
+                l_index );
+
+            if ( ( l_error != std::errc{} ) ||
+                 ( l_index >= _embedded.size() ) ||
+                 _embedded[ l_index ].data.empty() ) {
+                log::warning( "Wrong embedded texture '{}'", _name );
+
+                goto EXIT;
+            }
+
+            const cookedTexture_t& l_texture = _embedded[ l_index ];
+
+            if ( l_texture.width && l_texture.height ) {
+                l_width = l_texture.width;
+                l_height = l_texture.height;
+
+                l_pixels = static_cast< stbi_uc* >(
+                    malloc( l_texture.data.size() ) );
+
+                if ( !l_pixels ) {
+                    log::warning( "Allocating {} bytes for texture '{}'",
+                                  l_texture.data.size(), _name );
+
+                    goto EXIT;
+                }
+
+                std::ranges::copy(
+                    l_texture.data,
+                    reinterpret_cast< std::byte* >( l_pixels ) );
+
+            } else {
+                l_pixels = stbi_load_from_memory(
+                    reinterpret_cast< const stbi_uc* >(
+                        l_texture.data.data() ),
+                    l_texture.data.size(), &l_width, &l_height, &l_channels,
+                    4 );
+            }
+
+        } else {
+            l_pixels = stbi_load( std::string( _name ).c_str(), &l_width,
+                                  &l_height, &l_channels, 4 );
+        }
+
+        if ( !l_pixels ) {
+            log::warning( "Decoding texture '{}': {}", _name,
+                          stbi_failure_reason() );
+
+            goto EXIT;
+        }
+
+        const auto l_rgba = std::span(
+            l_pixels, ( static_cast< size_t >( l_width ) * l_height * 4 ) );
+        const compress::format_t l_format = compress::pickFormat( l_rgba );
+
+        std::vector< std::byte > l_dds;
+
+        if ( !compress::toDDS( l_rgba, l_width, l_height, l_format,
+                               l_dds ) ) {
+            log::warning( "Compressing texture '{}'", _name );
+
+            goto EXIT;
+        }
+
+        std::ofstream l_outputFileStream( std::string( _path ),
+                                          std::ios::binary );
+
+        l_outputFileStream.write(
+            reinterpret_cast< const char* >( l_dds.data() ), l_dds.size() );
+
+        if ( !l_outputFileStream.good() ) {
+            log::warning( "Writing '{}'", _path );
+
+            goto EXIT;
+        }
+
+        log::info(
+            "Compressed texture '{}' to '{}': {}x{} {}, {} -> {} bytes", _name,
+            _path, l_width, l_height,
+            ( ( l_format == compress::format_t::bc1 ) ? ( "BC1" ) : ( "BC3" ) ),
+            l_rgba.size(), l_dds.size() );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    // Both allocators are malloc
+    stbi_image_free( l_pixels );
+
+    return ( l_returnValue );
+}
+
+auto write( const std::string_view _path,
+            std::span< const cookedMesh_t > _meshes,
+            std::span< const cookedTexture_t > _textures ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        mesh::header_t l_header;
+        std::vector< mesh::record_t > l_records( _meshes.size() );
+        std::vector< mesh::texture_t > l_textures( _textures.size() );
+
+        // Layout
+        {
+            l_header.meshCount = _meshes.size();
+            l_header.textureCount = _textures.size();
+            l_header.recordsOffset = mesh::align( sizeof( mesh::header_t ) );
+            l_header.texturesOffset =
+                mesh::align( l_header.recordsOffset +
+                             ( l_records.size() * sizeof( mesh::record_t ) ) );
+
+            size_t l_offset = mesh::align(
+                l_header.texturesOffset +
+                ( l_textures.size() * sizeof( mesh::texture_t ) ) );
+
+            for ( auto [ l_index, l_record ] :
+                  l_records | std::views::enumerate ) {
+                const cookedMesh_t& l_cooked = _meshes[ l_index ];
+
+                l_record.vertexCount = l_cooked.vertices.size();
+                l_record.indexCount = l_cooked.indices.size();
+                l_record.lodCount = l_cooked.lods.size();
+                l_record.bounds = l_cooked.bounds;
+
+                std::ranges::copy( l_cooked.lods, l_record.lods.begin() );
+
+                if ( !l_cooked.quantizedVertices.empty() ) {
+                    l_record.flags |= mesh::g_flagQuantized;
+                    l_record.positionScale = l_cooked.positionScale;
+                    l_record.positionBias = l_cooked.positionBias;
+                }
+
+                std::ranges::copy( l_cooked.texture, l_record.texture.begin() );
+
+                l_record.verticesOffset = l_offset;
+                l_offset =
+                    mesh::align( l_offset + l_cooked.vertexData().size() );
+
+                l_record.indicesOffset = l_offset;
+                l_offset = mesh::align(
+                    l_offset +
+                    ( l_cooked.indices.size() * sizeof( mesh::index_t ) ) );
+            }
+
+            for ( auto [ l_index, l_texture ] :
+                  l_textures | std::views::enumerate ) {
+                const cookedTexture_t& l_cooked = _textures[ l_index ];
+
+                l_texture.size = l_cooked.data.size();
+                l_texture.width = l_cooked.width;
+                l_texture.height = l_cooked.height;
+
+                std::ranges::copy( l_cooked.hint, l_texture.hint.begin() );
+
+                l_texture.dataOffset = l_offset;
+                l_offset = mesh::align( l_offset + l_cooked.data.size() );
+            }
+
+            l_header.size = l_offset;
+        }
+
+        std::ofstream l_outputFileStream( std::string( _path ),
+                                          std::ios::binary );
+
+        if ( !l_outputFileStream.good() ) {
+            log::error( std::format( "Opening '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        // Pads stream up to the next block
+        auto l_pad = [ & ] {
+            static constexpr std::array< char, mesh::g_alignment > l_zeros{};
+
+            const size_t l_position = l_outputFileStream.tellp();
+
+            l_outputFileStream.write(
+                l_zeros.data(), ( mesh::align( l_position ) - l_position ) );
+        };
+
+        l_outputFileStream.write( reinterpret_cast< const char* >( &l_header ),
+                                  sizeof( l_header ) );
+        l_pad();
+
+        l_outputFileStream.write(
+            reinterpret_cast< const char* >( l_records.data() ),
+            ( l_records.size() * sizeof( mesh::record_t ) ) );
+        l_pad();
+
+        l_outputFileStream.write(
+            reinterpret_cast< const char* >( l_textures.data() ),
+            ( l_textures.size() * sizeof( mesh::texture_t ) ) );
+        l_pad();
+
+        for ( const cookedMesh_t& l_cooked : _meshes ) {
+            const std::span< const std::byte > l_vertexData =
+                l_cooked.vertexData();
+
+            l_outputFileStream.write(
+                reinterpret_cast< const char* >( l_vertexData.data() ),
+                l_vertexData.size() );
+            l_pad();
+
+            l_outputFileStream.write(
+                reinterpret_cast< const char* >( l_cooked.indices.data() ),
+                ( l_cooked.indices.size() * sizeof( mesh::index_t ) ) );
+            l_pad();
+        }
+
+        for ( const cookedTexture_t& l_cooked : _textures ) {
+            l_outputFileStream.write(
+                reinterpret_cast< const char* >( l_cooked.data.data() ),
+                l_cooked.data.size() );
+            l_pad();
+        }
+
+        if ( !l_outputFileStream.good() ) {
+            log::error( std::format( "Writing '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        log::info( "Wrote '{}': {} meshes, {} textures, {} bytes", _path,
+                   l_header.meshCount, l_header.textureCount, l_header.size );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto main( int _argumentCount, char** _argumentVector ) -> int {
+    bool l_returnValue = false;
+
+    {
+        const std::span< char* > l_arguments( _argumentVector,
+                                              _argumentCount );
+
+        const bool l_isQuantizing = ( ( l_arguments.size() == 4 ) &&
+                                      ( std::string_view( l_arguments[ 1 ] ) ==
+                                        "--quantize" ) );
+
+        if ( ( l_arguments.size() != 3 ) && !l_isQuantizing ) {
+            log::error(
+                "Usage: cooker [--quantize] <input model> <output mesh>" );
+
+            goto EXIT;
+        }
+
+        const std::string_view l_inputPath =
+            l_arguments[ l_arguments.size() - 2 ];
+        const std::string_view l_outputPath =
+            l_arguments[ l_arguments.size() - 1 ];
+
+        Assimp::Importer l_importer;
+
+        const aiScene* l_scene = l_importer.ReadFile(
+            std::string( l_inputPath ),
+            ( aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+              aiProcess_GenSmoothNormals | aiProcess_FlipUVs ) );
+
+        if ( !l_scene ) {
+            log::error( std::format( "Assimp ReadFile failed: '{}'",
+                                     l_importer.GetErrorString() ) );
+
+            goto EXIT;
+        }
+
+        log::info(
+            "Assimp: meshes = {}, materials = {}, embedded textures = {}",
+            l_scene->mNumMeshes, l_scene->mNumMaterials,
+            l_scene->mNumTextures );
+
+        std::vector< cookedMesh_t > l_meshes;
+
+        l_meshes.reserve( l_scene->mNumMeshes );
+
+        for ( unsigned l_index = 0; l_index < l_scene->mNumMeshes; l_index++ ) {
+            cookedMesh_t l_cooked;
+
+            if ( !cook( *l_scene, *( l_scene->mMeshes[ l_index ] ),
+                        l_cooked ) ) {
+                log::warning( "Skipping mesh[{}]", l_index );
+
+                continue;
+            }
+
+            log::info(
+                "Cooked mesh[{}]: verts = {}, indices = {}, texture = '{}'",
+                l_index, l_cooked.vertices.size(), l_cooked.indices.size(),
+                l_cooked.texture );
+
+            // Vertex cache, then overdraw on top of it, then fetch order
+            {
+                const optimize::statistics_t l_before = optimize::analyze(
+                    l_cooked.indices, l_cooked.vertices.size() );
+
+                optimize::vertexCache( l_cooked.indices,
+                                       l_cooked.vertices.size() );
+                optimize::overdraw( l_cooked.indices, l_cooked.vertices );
+                optimize::vertexFetch( l_cooked.vertices, l_cooked.indices );
+
+                const optimize::statistics_t l_after = optimize::analyze(
+                    l_cooked.indices, l_cooked.vertices.size() );
+
+                log::info( "Optimized mesh[{}]: ACMR {:.3f} -> {:.3f}, "
+                           "ATVR {:.3f} -> {:.3f}",
+                           l_index, l_before.acmr, l_after.acmr, l_before.atvr,
+                           l_after.atvr );
+            }
+
+            l_cooked.bounds = simplify::bounds( l_cooked.vertices );
+
+            // Levels of detail, each simplified from the previous one, so
+            // their errors add up
+            {
+                l_cooked.lods.push_back(
+                    { .indexCount = static_cast< uint32_t >(
+                          l_cooked.indices.size() ) } );
+
+                std::vector< mesh::index_t > l_previous = l_cooked.indices;
+                float l_error = 0.0F;
+
+                while ( l_cooked.lods.size() < mesh::g_maxLodCount ) {
+                    std::vector< mesh::index_t > l_lod;
+
+                    const size_t l_targetIndexCount =
+                        ( static_cast< size_t >(
+                              static_cast< float >( l_previous.size() / 3 ) *
+                              g_lodReduction ) *
+                          3 );
+
+                    l_error += simplify::edgeCollapse(
+                        l_previous, l_cooked.vertices, l_targetIndexCount,
+                        ( ( l_cooked.bounds[ 3 ] * g_lodMaxError ) - l_error ),
+                        l_lod );
+
+                    if ( static_cast< float >( l_lod.size() ) >
+                         ( static_cast< float >( l_previous.size() ) *
+                           ( 1.0F - g_lodMinReduction ) ) ) {
+                        break;
+                    }
+
+                    optimize::vertexCache( l_lod, l_cooked.vertices.size() );
+
+                    l_cooked.lods.push_back(
+                        { .indexOffset = static_cast< uint32_t >(
+                              l_cooked.indices.size() ),
+                          .indexCount = static_cast< uint32_t >( l_lod.size() ),
+                          .error = l_error } );
+
+                    l_cooked.indices.insert( l_cooked.indices.end(),
+                                             l_lod.begin(), l_lod.end() );
+
+                    log::info( "Mesh[{}] level {}: {} triangles, error {:.4f}",
+                               l_index, ( l_cooked.lods.size() - 1 ),
+                               ( l_lod.size() / 3 ), l_error );
+
+                    l_previous = std::move( l_lod );
+                }
+            }
+
+            // After reordering, optimizer works on full precision
+            if ( l_isQuantizing ) {
+                if ( quantize::vertices(
+                         l_cooked.vertices, l_cooked.quantizedVertices,
+                         l_cooked.positionScale, l_cooked.positionBias ) ) {
+                    log::info( "Quantized mesh[{}]: {} -> {} bytes", l_index,
+                               ( l_cooked.vertices.size() *
+                                 sizeof( mesh::vertex_t ) ),
+                               l_cooked.vertexData().size() );
+
+                } else {
+                    log::info( "Mesh[{}] texture coordinates exceed {}, "
+                               "keeping full precision",
+                               l_index, quantize::g_maxTextureCoordinate );
+                }
+            }
+
+            l_meshes.emplace_back( std::move( l_cooked ) );
+        }
+
+        if ( l_meshes.empty() ) {
+            log::error( "Model contains no meshes" );
+
+            goto EXIT;
+        }
+
+        // Embedded textures keep their indices, meshes reference them as "*N"
+        std::vector< cookedTexture_t > l_textures( l_scene->mNumTextures );
+
+        for ( auto [ l_index, l_cooked ] :
+              l_textures | std::views::enumerate ) {
+            if ( !cook( *( l_scene->mTextures[ l_index ] ), l_cooked ) ) {
+                log::warning( "Skipping embedded texture[{}]", l_index );
+
+                continue;
+            }
+
+            log::info( "Cooked embedded texture[{}]: bytes = {}, format = '{}'",
+                       l_index, l_cooked.data.size(),
+                       ( l_cooked.hint.empty() ? "rgba8" : l_cooked.hint ) );
+        }
+
+        // Block compress every referenced texture into its own container,
+        // meshes reference container path instead
+        {
+            std::unordered_map< std::string, std::string > l_containers;
+
+            for ( cookedMesh_t& l_cooked : l_meshes ) {
+                if ( l_cooked.texture.empty() ) {
+                    continue;
+                }
+
+                auto [ l_iterator, l_isInserted ] =
+                    l_containers.try_emplace( l_cooked.texture );
+
+                if ( l_isInserted ) {
+                    std::string l_containerPath =
+                        std::format( "{}.{}.dds", l_outputPath,
+                                     ( l_containers.size() - 1 ) );
+
+                    if ( ( l_containerPath.size() <
+                           mesh::g_textureNameLength ) &&
+                         compressTexture( l_cooked.texture, l_textures,
+                                          l_containerPath ) ) {
+                        l_iterator->second = std::move( l_containerPath );
+                    }
+                }
+
+                // Runtime decodes original on failure
+                if ( !l_iterator->second.empty() ) {
+                    l_cooked.texture = l_iterator->second;
+                }
+            }
+        }
+
+        if ( !write( l_outputPath, l_meshes, l_textures ) ) {
+            log::error( "Writing cooked mesh" );
+
+            goto EXIT;
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( ( l_returnValue ) ? ( EXIT_SUCCESS ) : ( EXIT_FAILURE ) );
+}
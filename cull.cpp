@@ -0,0 +1,184 @@
+#include "cull.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+
+#include <immintrin.h>
+
+#endif
+
+namespace cull {
+
+namespace {
+
+// Padding fails every plane test
+inline constexpr const float g_paddingRadius =
+    std::numeric_limits< float >::lowest();
+
+} // namespace
+
+void bounds_t::resize( size_t _count ) {
+    const size_t l_paddedCount = ( ( ( _count + g_width - 1 ) / g_width ) *
+                                   g_width );
+
+    x.resize( l_paddedCount, 0.0F );
+    y.resize( l_paddedCount, 0.0F );
+    z.resize( l_paddedCount, 0.0F );
+    radius.resize( l_paddedCount, g_paddingRadius );
+
+    // Shrinking turns dropped tail into padding
+    for ( size_t l_index = _count; l_index < l_paddedCount; l_index++ ) {
+        radius[ l_index ] = g_paddingRadius;
+    }
+
+    count = _count;
+}
+
+void bounds_t::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+
+    count = 0;
+}
+
+void bounds_t::set( size_t _index, const std::array< float, 4 >& _sphere ) {
+    x[ _index ] = _sphere[ 0 ];
+    y[ _index ] = _sphere[ 1 ];
+    z[ _index ] = _sphere[ 2 ];
+    radius[ _index ] = _sphere[ 3 ];
+}
+
+auto frustum( const float* _viewProjection, bool _isHomogeneousDepth )
+    -> frustum_t {
+    frustum_t l_returnValue{};
+
+    // Clip coordinate is dot of position with matrix column
+    auto l_column = [ & ]( size_t _column ) {
+        return ( std::array< float, 4 >{ _viewProjection[ 0 + _column ],
+                                         _viewProjection[ 4 + _column ],
+                                         _viewProjection[ 8 + _column ],
+                                         _viewProjection[ 12 + _column ] } );
+    };
+
+    const std::array< float, 4 > l_x = l_column( 0 );
+    const std::array< float, 4 > l_y = l_column( 1 );
+    const std::array< float, 4 > l_z = l_column( 2 );
+    const std::array< float, 4 > l_w = l_column( 3 );
+
+    for ( size_t l_element = 0; l_element < 4; l_element++ ) {
+        const float l_wElement = l_w[ l_element ];
+
+        // Left, right, bottom, top
+        l_returnValue[ 0 ][ l_element ] = ( l_wElement + l_x[ l_element ] );
+        l_returnValue[ 1 ][ l_element ] = ( l_wElement - l_x[ l_element ] );
+        l_returnValue[ 2 ][ l_element ] = ( l_wElement + l_y[ l_element ] );
+        l_returnValue[ 3 ][ l_element ] = ( l_wElement - l_y[ l_element ] );
+
+        // Near depends on clip depth range, far
+        l_returnValue[ 4 ][ l_element ] =
+            ( ( _isHomogeneousDepth ) ? ( l_wElement + l_z[ l_element ] )
+                                      : ( l_z[ l_element ] ) );
+        l_returnValue[ 5 ][ l_element ] = ( l_wElement - l_z[ l_element ] );
+    }
+
+    // Unit normals make plane distances comparable with radii
+    for ( std::array< float, 4 >& l_plane : l_returnValue ) {
+        const float l_length = std::sqrt( ( l_plane[ 0 ] * l_plane[ 0 ] ) +
+                                          ( l_plane[ 1 ] * l_plane[ 1 ] ) +
+                                          ( l_plane[ 2 ] * l_plane[ 2 ] ) );
+
+        if ( l_length > 0.0F ) {
+            for ( float& l_element : l_plane ) {
+                l_element /= l_length;
+            }
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+void visible( const bounds_t& _bounds,
+              const frustum_t& _frustum,
+              std::vector< uint32_t >& _visible ) {
+    const size_t l_paddedCount = _bounds.radius.size();
+
+    // Every tested object may be written, tail is trimmed afterwards
+    _visible.resize( l_paddedCount );
+
+    size_t l_visibleCount = 0;
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+
+    // Vector types lose alignment attributes in templates
+    __m256 l_planes[ 6 ][ 4 ];
+
+    for ( size_t l_plane = 0; l_plane < _frustum.size(); l_plane++ ) {
+        for ( size_t l_element = 0; l_element < 4; l_element++ ) {
+            l_planes[ l_plane ][ l_element ] =
+                _mm256_set1_ps( _frustum[ l_plane ][ l_element ] );
+        }
+    }
+
+    const __m256 l_signMask = _mm256_set1_ps( -0.0F );
+
+    for ( size_t l_first = 0; l_first < l_paddedCount; l_first += g_width ) {
+        const __m256 l_x = _mm256_loadu_ps( _bounds.x.data() + l_first );
+        const __m256 l_y = _mm256_loadu_ps( _bounds.y.data() + l_first );
+        const __m256 l_z = _mm256_loadu_ps( _bounds.z.data() + l_first );
+        const __m256 l_negativeRadius = _mm256_xor_ps(
+            _mm256_loadu_ps( _bounds.radius.data() + l_first ), l_signMask );
+
+        __m256 l_isInside = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+
+        for ( const auto& l_plane : l_planes ) {
+            const __m256 l_distance = _mm256_fmadd_ps(
+                l_plane[ 0 ], l_x,
+                _mm256_fmadd_ps(
+                    l_plane[ 1 ], l_y,
+                    _mm256_fmadd_ps( l_plane[ 2 ], l_z, l_plane[ 3 ] ) ) );
+
+            l_isInside = _mm256_and_ps(
+                l_isInside,
+                _mm256_cmp_ps( l_distance, l_negativeRadius, _CMP_GT_OQ ) );
+        }
+
+        auto l_mask =
+            static_cast< uint32_t >( _mm256_movemask_ps( l_isInside ) );
+
+        while ( l_mask ) {
+            _visible[ l_visibleCount++ ] =
+                ( l_first + std::countr_zero( l_mask ) );
+
+            l_mask &= ( l_mask - 1 );
+        }
+    }
+
+#else
+
+    for ( size_t l_index = 0; l_index < l_paddedCount; l_index++ ) {
+        bool l_isInside = true;
+
+        for ( const std::array< float, 4 >& l_plane : _frustum ) {
+            const float l_distance =
+                ( ( l_plane[ 0 ] * _bounds.x[ l_index ] ) +
+                  ( l_plane[ 1 ] * _bounds.y[ l_index ] ) +
+                  ( l_plane[ 2 ] * _bounds.z[ l_index ] ) + l_plane[ 3 ] );
+
+            l_isInside &= ( l_distance > -_bounds.radius[ l_index ] );
+        }
+
+        _visible[ l_visibleCount ] = l_index;
+        l_visibleCount += l_isInside;
+    }
+
+#endif
+
+    _visible.resize( l_visibleCount );
+}
+
+} // namespace cull
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Frustum culling of bounding spheres
+namespace cull {
+
+// Objects tested per iteration, one AVX2 register of floats
+inline constexpr const size_t g_width = 8;
+
+// Bounding spheres, one array per component
+// Arrays are padded up to g_width with spheres that are never visible
+using bounds_t = struct bounds {
+    bounds() = default;
+    bounds( const bounds& ) = default;
+    bounds( bounds&& ) = default;
+    ~bounds() = default;
+    auto operator=( const bounds& ) -> bounds& = default;
+    auto operator=( bounds&& ) -> bounds& = default;
+
+    void resize( size_t _count );
+    void clear();
+
+    // Center and radius
+    void set( size_t _index, const std::array< float, 4 >& _sphere );
+
+    std::vector< float > x;
+    std::vector< float > y;
+    std::vector< float > z;
+    std::vector< float > radius;
+    size_t count = 0;
+};
+
+// Planes as ( a, b, c, d ), point is inside if a * x + b * y + c * z + d >= 0
+using frustum_t = std::array< std::array< float, 4 >, 6 >;
+
+// Planes of row vector matrix, in space the matrix transforms from
+// Model view projection gives planes in model space
+auto frustum( const float* _viewProjection, bool _isHomogeneousDepth )
+    -> frustum_t;
+
+// Indices of spheres intersecting frustum, in increasing order
+void visible( const bounds_t& _bounds,
+              const frustum_t& _frustum,
+              std::vector< uint32_t >& _visible );
+
+} // namespace cull
@@ -0,0 +1,430 @@
+#include "draw.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ranges>
+#include <utility>
+
+#include "job.hpp"
+#include "log.hpp"
+#include "profile.hpp"
+
+namespace draw {
+
+namespace {
+
+inline constexpr const uint32_t g_viewBits = 8;
+inline constexpr const uint32_t g_programBits = 9;
+inline constexpr const uint32_t g_textureBits = 12;
+inline constexpr const uint32_t g_stateBits = 11;
+inline constexpr const uint32_t g_vertexBufferBits = 12;
+inline constexpr const uint32_t g_depthBits = 12;
+
+static_assert( ( g_viewBits + g_programBits + g_textureBits + g_stateBits +
+                 g_vertexBufferBits + g_depthBits ) == 64 );
+
+inline constexpr const uint32_t g_depthShift = 0;
+inline constexpr const uint32_t g_vertexBufferShift =
+    ( g_depthShift + g_depthBits );
+inline constexpr const uint32_t g_stateShift =
+    ( g_vertexBufferShift + g_vertexBufferBits );
+inline constexpr const uint32_t g_textureShift =
+    ( g_stateShift + g_stateBits );
+inline constexpr const uint32_t g_programShift =
+    ( g_textureShift + g_textureBits );
+inline constexpr const uint32_t g_viewShift =
+    ( g_programShift + g_programBits );
+
+inline constexpr const uint32_t g_none = UINT32_MAX;
+
+// bx matrix, one row per instance data vec4
+inline constexpr const uint16_t g_instanceStride = sizeof( float[ 16 ] );
+
+inline constexpr const size_t g_radixBits = 8;
+inline constexpr const size_t g_radixSize = ( 1 << g_radixBits );
+
+constexpr auto field( uint64_t _value, uint32_t _bits, uint32_t _shift )
+    -> uint64_t {
+    return ( ( _value & ( ( uint64_t{ 1 } << _bits ) - 1 ) ) << _shift );
+}
+
+// Least significant digit first, passes where every key has the same digit
+// are skipped
+void radixSort( std::vector< std::array< uint64_t, 2 > >& _order,
+                std::vector< std::array< uint64_t, 2 > >& _scratch ) {
+    _scratch.resize( _order.size() );
+
+    std::array< size_t, g_radixSize > l_histogram;
+
+    for ( size_t l_shift = 0; l_shift < 64; l_shift += g_radixBits ) {
+        l_histogram.fill( 0 );
+
+        for ( const auto& l_entry : _order ) {
+            l_histogram[ ( l_entry[ 0 ] >> l_shift ) & ( g_radixSize - 1 ) ]++;
+        }
+
+        if ( std::ranges::find( l_histogram, _order.size() ) !=
+             l_histogram.end() ) {
+            continue;
+        }
+
+        size_t l_offset = 0;
+
+        for ( size_t& l_count : l_histogram ) {
+            l_offset += std::exchange( l_count, l_offset );
+        }
+
+        for ( const auto& l_entry : _order ) {
+            _scratch[ l_histogram[ ( l_entry[ 0 ] >> l_shift ) &
+                                   ( g_radixSize - 1 ) ]++ ] = l_entry;
+        }
+
+        std::swap( _order, _scratch );
+    }
+}
+
+// Everything but transform matches
+auto isInstanceOf( const draw_t& _draw, const draw_t& _first ) -> bool {
+    auto l_isSameUniform = []( const uniform_t& _lhs, const uniform_t& _rhs ) {
+        return ( ( _lhs.handle.idx == _rhs.handle.idx ) &&
+                 ( _lhs.value == _rhs.value ) );
+    };
+
+    return ( ( _draw.view == _first.view ) &&
+             ( _draw.program.idx == _first.program.idx ) &&
+             ( _draw.instancedProgram.idx == _first.instancedProgram.idx ) &&
+             ( _draw.vertexBuffer.idx == _first.vertexBuffer.idx ) &&
+             ( _draw.indexBuffer.idx == _first.indexBuffer.idx ) &&
+             ( _draw.firstIndex == _first.firstIndex ) &&
+             ( _draw.indexCount == _first.indexCount ) &&
+             ( _draw.sampler.idx == _first.sampler.idx ) &&
+             ( _draw.texture.idx == _first.texture.idx ) &&
+             ( _draw.state == _first.state ) &&
+             std::ranges::equal( _draw.uniforms, _first.uniforms,
+                                 l_isSameUniform ) );
+}
+
+// Records batches [ _first, _end ), encoder starts with nothing bound
+auto record( const list_t& _list,
+             size_t _first,
+             size_t _end,
+             bgfx::Encoder& _encoder ) -> statistics_t {
+    statistics_t l_returnValue;
+
+    const draw_t* l_previous = nullptr;
+    // Transform is not part of instanced draws, so it is tracked on its own
+    uint32_t l_boundTransform = g_none;
+
+    auto l_drawAt = [ & ]( size_t _position ) -> const draw_t& {
+        return ( _list.draws[ _list.order[ _position ][ 1 ] ] );
+    };
+
+    for ( size_t l_batch = _first; l_batch < _end; l_batch++ ) {
+        const batch_t& l_current = _list.batches[ l_batch ];
+        const draw_t& l_draw = l_drawAt( l_current.position );
+        const draw_t* l_next =
+            ( ( ( l_batch + 1 ) < _end )
+                  ? ( &l_drawAt( _list.batches[ l_batch + 1 ].position ) )
+                  : ( nullptr ) );
+        const bool l_isInstanced = ( l_current.count > 1 );
+
+        // Bindings kept by previous submit are not set again
+        const bool l_isSameState =
+            ( l_previous && ( l_previous->state == l_draw.state ) );
+        const bool l_isSameTransform =
+            ( l_isInstanced || ( l_boundTransform == l_draw.transform ) );
+        const bool l_isSameVertexBuffer =
+            ( l_previous &&
+              ( l_previous->vertexBuffer.idx == l_draw.vertexBuffer.idx ) );
+        const bool l_isSameIndexBuffer =
+            ( l_previous &&
+              ( l_previous->indexBuffer.idx == l_draw.indexBuffer.idx ) &&
+              ( l_previous->firstIndex == l_draw.firstIndex ) &&
+              ( l_previous->indexCount == l_draw.indexCount ) );
+        const bool l_isSameTexture =
+            ( l_previous && ( l_previous->texture.idx == l_draw.texture.idx ) &&
+              ( l_previous->sampler.idx == l_draw.sampler.idx ) );
+
+        if ( !l_isSameState ) {
+            _encoder.setState( l_draw.state );
+        }
+
+        if ( !l_isSameTransform ) {
+            _encoder.setTransform(
+                _list.transforms[ l_draw.transform ].data() );
+
+            l_boundTransform = l_draw.transform;
+        }
+
+        if ( !l_isSameVertexBuffer ) {
+            _encoder.setVertexBuffer( 0, l_draw.vertexBuffer );
+        }
+
+        if ( !l_isSameIndexBuffer ) {
+            _encoder.setIndexBuffer( l_draw.indexBuffer, l_draw.firstIndex,
+                                     l_draw.indexCount );
+        }
+
+        if ( !l_isSameTexture && bgfx::isValid( l_draw.texture ) ) {
+            _encoder.setTexture( 0, l_draw.sampler, l_draw.texture );
+        }
+
+        // Uniform values are renderer wide and draws of parallel encoders
+        // interleave by sort key, so every draw sets its own
+        for ( const uniform_t& l_uniform : l_draw.uniforms ) {
+            if ( bgfx::isValid( l_uniform.handle ) ) {
+                _encoder.setUniform( l_uniform.handle,
+                                     l_uniform.value.data() );
+            }
+        }
+
+        if ( l_isInstanced ) {
+            for ( size_t l_instance = 0; l_instance < l_current.count;
+                  l_instance++ ) {
+                const std::array< float, 16 >& l_transform =
+                    _list.transforms[ l_drawAt( l_current.position +
+                                                l_instance )
+                                          .transform ];
+
+                std::memcpy( ( l_current.instanceData.data +
+                               ( l_instance * g_instanceStride ) ),
+                             l_transform.data(), g_instanceStride );
+            }
+
+            _encoder.setInstanceDataBuffer( &l_current.instanceData );
+        }
+
+        // Keep everything next draw shares
+        uint8_t l_discard = BGFX_DISCARD_ALL;
+
+        if ( l_next ) {
+            l_discard = BGFX_DISCARD_INSTANCE_DATA;
+
+            if ( l_next->state != l_draw.state ) {
+                l_discard |= BGFX_DISCARD_STATE;
+            }
+
+            if ( l_next->transform != l_boundTransform ) {
+                l_discard |= BGFX_DISCARD_TRANSFORM;
+            }
+
+            if ( l_next->vertexBuffer.idx != l_draw.vertexBuffer.idx ) {
+                l_discard |= BGFX_DISCARD_VERTEX_STREAMS;
+            }
+
+            if ( ( l_next->indexBuffer.idx != l_draw.indexBuffer.idx ) ||
+                 ( l_next->firstIndex != l_draw.firstIndex ) ||
+                 ( l_next->indexCount != l_draw.indexCount ) ) {
+                l_discard |= BGFX_DISCARD_INDEX_BUFFER;
+            }
+
+            if ( ( l_next->texture.idx != l_draw.texture.idx ) ||
+                 ( l_next->sampler.idx != l_draw.sampler.idx ) ) {
+                l_discard |= BGFX_DISCARD_BINDINGS;
+            }
+        }
+
+        if ( l_discard & BGFX_DISCARD_TRANSFORM ) {
+            l_boundTransform = g_none;
+        }
+
+        _encoder.submit( l_draw.view,
+                         ( ( l_isInstanced ) ? ( l_draw.instancedProgram )
+                                             : ( l_draw.program ) ),
+                         0, l_discard );
+
+        l_returnValue.draws++;
+        l_returnValue.programChanges +=
+            ( !l_previous ||
+              ( l_previous->program.idx != l_draw.program.idx ) );
+        l_returnValue.stateChanges += !l_isSameState;
+        l_returnValue.stateChangesSaved += l_isSameState;
+        l_returnValue.bufferBinds +=
+            ( !l_isSameVertexBuffer + !l_isSameIndexBuffer );
+        l_returnValue.bufferBindsSaved +=
+            ( l_isSameVertexBuffer + l_isSameIndexBuffer );
+
+        if ( l_isInstanced ) {
+            l_returnValue.instancedDraws++;
+            l_returnValue.instances += l_current.count;
+
+        } else {
+            l_returnValue.transforms += !l_isSameTransform;
+            l_returnValue.transformsSaved += l_isSameTransform;
+        }
+
+        if ( bgfx::isValid( l_draw.texture ) ) {
+            l_returnValue.textureBinds += !l_isSameTexture;
+            l_returnValue.textureBindsSaved += l_isSameTexture;
+        }
+
+        l_previous = &l_draw;
+    }
+
+    return ( l_returnValue );
+}
+
+void accumulate( statistics_t& _total, const statistics_t& _chunk ) {
+    _total.draws += _chunk.draws;
+    _total.encoders += _chunk.encoders;
+    _total.instancedDraws += _chunk.instancedDraws;
+    _total.instances += _chunk.instances;
+    _total.programChanges += _chunk.programChanges;
+    _total.stateChanges += _chunk.stateChanges;
+    _total.stateChangesSaved += _chunk.stateChangesSaved;
+    _total.textureBinds += _chunk.textureBinds;
+    _total.textureBindsSaved += _chunk.textureBindsSaved;
+    _total.bufferBinds += _chunk.bufferBinds;
+    _total.bufferBindsSaved += _chunk.bufferBindsSaved;
+    _total.transforms += _chunk.transforms;
+    _total.transformsSaved += _chunk.transformsSaved;
+}
+
+} // namespace
+
+void clear( list_t& _list ) {
+    _list.draws.clear();
+    _list.transforms.clear();
+    _list.states.clear();
+}
+
+auto transform( list_t& _list, const float* _matrix ) -> uint32_t {
+    std::array< float, 16 >& l_transform = _list.transforms.emplace_back();
+
+    std::copy_n( _matrix, l_transform.size(), l_transform.begin() );
+
+    return ( _list.transforms.size() - 1 );
+}
+
+void push( list_t& _list, const draw_t& _draw, float _depth ) {
+    auto l_state = std::ranges::find( _list.states, _draw.state );
+
+    if ( l_state == _list.states.end() ) {
+        _list.states.push_back( _draw.state );
+
+        l_state = ( _list.states.end() - 1 );
+    }
+
+    const auto l_depth = static_cast< uint64_t >(
+        std::clamp( _depth, 0.0F, 1.0F ) *
+        static_cast< float >( ( uint64_t{ 1 } << g_depthBits ) - 1 ) );
+
+    draw_t& l_draw = _list.draws.emplace_back( _draw );
+
+    l_draw.key =
+        ( field( _draw.view, g_viewBits, g_viewShift ) |
+          field( _draw.program.idx, g_programBits, g_programShift ) |
+          field( _draw.texture.idx, g_textureBits, g_textureShift ) |
+          field( ( l_state - _list.states.begin() ), g_stateBits,
+                 g_stateShift ) |
+          field( _draw.vertexBuffer.idx, g_vertexBufferBits,
+                 g_vertexBufferShift ) |
+          field( l_depth, g_depthBits, g_depthShift ) );
+}
+
+auto submit( list_t& _list ) -> statistics_t {
+    PROFILE_SCOPE( "draw::submit" );
+
+    statistics_t l_returnValue;
+
+    _list.order.clear();
+
+    for ( const auto [ l_index, l_draw ] :
+          _list.draws | std::views::enumerate ) {
+        _list.order.push_back( { l_draw.key, static_cast< uint64_t >(
+                                                 l_index ) } );
+    }
+
+    radixSort( _list.order, _list.scratch );
+
+    auto l_drawAt = [ & ]( size_t _position ) -> const draw_t& {
+        return ( _list.draws[ _list.order[ _position ][ 1 ] ] );
+    };
+
+    // Batches and instance data are decided here, so recording threads do
+    // not race for instance data buffer space
+    _list.batches.clear();
+
+    for ( size_t l_position = 0; l_position < _list.order.size(); ) {
+        const draw_t& l_draw = l_drawAt( l_position );
+
+        // Run of copies, capped by what instance data buffer has left
+        size_t l_instanceCount = 1;
+
+        if ( bgfx::isValid( l_draw.instancedProgram ) ) {
+            while ( ( ( l_position + l_instanceCount ) < _list.order.size() ) &&
+                    isInstanceOf( l_drawAt( l_position + l_instanceCount ),
+                                  l_draw ) ) {
+                l_instanceCount++;
+            }
+
+            if ( l_instanceCount >= g_minInstanceCount ) {
+                l_instanceCount = bgfx::getAvailInstanceDataBuffer(
+                    l_instanceCount, g_instanceStride );
+            }
+
+            if ( l_instanceCount < g_minInstanceCount ) {
+                l_instanceCount = 1;
+            }
+        }
+
+        batch_t& l_batch = _list.batches.emplace_back();
+
+        l_batch.position = l_position;
+        l_batch.count = l_instanceCount;
+
+        if ( l_instanceCount > 1 ) {
+            bgfx::allocInstanceDataBuffer( &l_batch.instanceData,
+                                           l_instanceCount, g_instanceStride );
+        }
+
+        l_position += l_instanceCount;
+    }
+
+    // Contiguous chunks, one encoder each
+    // Main thread encoder is not handed out
+    const size_t l_chunkCount = std::max(
+        std::min( { ( job::threadCount() + 1 ),
+                    static_cast< size_t >(
+                        bgfx::getCaps()->limits.maxEncoders - 1 ),
+                    ( _list.batches.size() / g_minBatchesPerChunk ) } ),
+        1UZ );
+    const size_t l_chunkSize =
+        ( ( _list.batches.size() + l_chunkCount - 1 ) / l_chunkCount );
+
+    _list.chunkStatistics.assign( l_chunkCount, statistics_t{} );
+
+    job::parallelFor( l_chunkCount, [ & ]( size_t _chunk ) {
+        const size_t l_first = ( _chunk * l_chunkSize );
+        const size_t l_end =
+            std::min( ( l_first + l_chunkSize ), _list.batches.size() );
+
+        if ( l_first >= l_end ) {
+            return;
+        }
+
+        PROFILE_SCOPE( "draw::record" );
+
+        bgfx::Encoder* l_encoder = bgfx::begin( true );
+
+        if ( !l_encoder ) {
+            log::error( "No free encoder" );
+
+            return;
+        }
+
+        _list.chunkStatistics[ _chunk ] =
+            record( _list, l_first, l_end, *l_encoder );
+        _list.chunkStatistics[ _chunk ].encoders = 1;
+
+        bgfx::end( l_encoder );
+    } );
+
+    for ( const statistics_t& l_chunk : _list.chunkStatistics ) {
+        accumulate( l_returnValue, l_chunk );
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace draw
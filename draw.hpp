@@ -0,0 +1,121 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sorted draw submission
+//
+// Key, most significant first:
+// [ view 8 ][ program 9 ][ texture 12 ][ state 11 ][ vertex buffer 12 ]
+// [ depth 12 ]
+//
+// Copies of a mesh sort next to each other and are drawn instanced
+// Sorted list is recorded in contiguous chunks through one bgfx encoder per
+// job, so only bgfx::frame is left to game thread
+namespace draw {
+
+inline constexpr const size_t g_maxUniforms = 2;
+// Fewer copies are cheaper as plain draws
+inline constexpr const size_t g_minInstanceCount = 2;
+// Smaller chunks cost more in encoder setup than they save
+inline constexpr const size_t g_minBatchesPerChunk = 256;
+
+using uniform_t = struct uniform {
+    bgfx::UniformHandle handle = BGFX_INVALID_HANDLE;
+    std::array< float, 4 > value{};
+};
+
+using draw_t = struct draw {
+    // Filled by push
+    uint64_t key = 0;
+
+    bgfx::ViewId view = 0;
+    bgfx::ProgramHandle program = BGFX_INVALID_HANDLE;
+    // Same program with model matrix from instance data, invalid if none
+    bgfx::ProgramHandle instancedProgram = BGFX_INVALID_HANDLE;
+    bgfx::VertexBufferHandle vertexBuffer = BGFX_INVALID_HANDLE;
+    bgfx::IndexBufferHandle indexBuffer = BGFX_INVALID_HANDLE;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // Stage 0, none if texture is invalid
+    bgfx::UniformHandle sampler = BGFX_INVALID_HANDLE;
+    bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+    uint64_t state = BGFX_STATE_DEFAULT;
+    // Index returned by transform
+    uint32_t transform = 0;
+    // Vec4 uniforms, unused have invalid handle
+    std::array< uniform_t, g_maxUniforms > uniforms{};
+};
+
+// Per frame, counts what consecutive draws shared and were not set again
+using statistics_t = struct statistics {
+    statistics() = default;
+    statistics( const statistics& ) = default;
+    statistics( statistics&& ) = default;
+    ~statistics() = default;
+    auto operator=( const statistics& ) -> statistics& = default;
+    auto operator=( statistics&& ) -> statistics& = default;
+
+    // Submit calls, instanced ones count once
+    size_t draws = 0;
+    // Recorded in parallel
+    size_t encoders = 0;
+    size_t instancedDraws = 0;
+    // Draws folded into instanced ones
+    size_t instances = 0;
+    size_t programChanges = 0;
+    size_t stateChanges = 0;
+    size_t stateChangesSaved = 0;
+    size_t textureBinds = 0;
+    size_t textureBindsSaved = 0;
+    size_t bufferBinds = 0;
+    size_t bufferBindsSaved = 0;
+    size_t transforms = 0;
+    size_t transformsSaved = 0;
+};
+
+// Draws submitted with one call, more than one are instanced
+using batch_t = struct batch {
+    // Into sorted order
+    size_t position = 0;
+    size_t count = 0;
+    bgfx::InstanceDataBuffer instanceData{};
+};
+
+// Reused between frames, so steady state does not allocate
+using list_t = struct list {
+    list() = default;
+    list( const list& ) = delete;
+    list( list&& ) = delete;
+    ~list() = default;
+    auto operator=( const list& ) -> list& = delete;
+    auto operator=( list&& ) -> list& = delete;
+
+    std::vector< draw_t > draws;
+    std::vector< std::array< float, 16 > > transforms;
+    // Unique render states of frame, key stores index
+    std::vector< uint64_t > states;
+    // Key and draw index, sorted and scratch
+    std::vector< std::array< uint64_t, 2 > > order;
+    std::vector< std::array< uint64_t, 2 > > scratch;
+    std::vector< batch_t > batches;
+    std::vector< statistics_t > chunkStatistics;
+};
+
+void clear( list_t& _list );
+
+auto transform( list_t& _list, const float* _matrix ) -> uint32_t;
+
+// Opaque front to back, _depth is 0 at camera and 1 at far plane
+void push( list_t& _list, const draw_t& _draw, float _depth );
+
+// Sorts by key and submits, setting only what differs from previous draw
+// Consecutive draws differing only in transform go out as one instanced draw
+// Main thread only, job system records chunks
+auto submit( list_t& _list ) -> statistics_t;
+
+} // namespace draw
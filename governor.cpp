@@ -0,0 +1,202 @@
+#include "governor.hpp"
+
+#include <algorithm>
+
+#include "log.hpp"
+#include "vsync.hpp"
+
+namespace governor {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+float g_activeFPS = 0;
+mode_t g_mode = mode_t::active;
+
+bool g_isFocused = true;
+bool g_isMinimized = false;
+bool g_isOccluded = false;
+clock::time_point g_lastInput;
+
+auto desiredMode() -> mode_t {
+    mode_t l_returnValue = mode_t::active;
+
+    if ( g_isMinimized || g_isOccluded ) {
+        l_returnValue = mode_t::hidden;
+
+    } else if ( !g_isFocused ) {
+        l_returnValue = mode_t::background;
+
+    } else if ( ( clock::now() - g_lastInput ) > g_idleTimeout ) {
+        l_returnValue = mode_t::idle;
+    }
+
+    return ( l_returnValue );
+}
+
+auto desiredFPS( mode_t _mode ) -> float {
+    float l_returnValue = g_activeFPS;
+
+    switch ( _mode ) {
+        case mode_t::idle: {
+            l_returnValue = std::min( g_activeFPS, g_idleFPS );
+
+            break;
+        }
+
+        // Hidden paces itself by waiting on events
+        case mode_t::background:
+        case mode_t::hidden: {
+            l_returnValue = std::min( g_activeFPS, g_backgroundFPS );
+
+            break;
+        }
+
+        default: {
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto init( float _activeFPS ) -> bool {
+    log::variable( _activeFPS );
+
+    bool l_returnValue = false;
+
+    {
+        if ( g_activeFPS ) {
+            log::error( "Already initialized" );
+
+            goto EXIT;
+        }
+
+        g_activeFPS = _activeFPS;
+        g_mode = mode_t::active;
+        g_isFocused = true;
+        g_isMinimized = false;
+        g_isOccluded = false;
+        g_lastInput = clock::now();
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void quit() {
+    g_activeFPS = 0;
+}
+
+void event( const SDL_Event& _event ) {
+    switch ( _event.type ) {
+        case SDL_EVENT_WINDOW_FOCUS_GAINED: {
+            g_isFocused = true;
+
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_FOCUS_LOST: {
+            g_isFocused = false;
+
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_MINIMIZED:
+        case SDL_EVENT_WINDOW_HIDDEN: {
+            g_isMinimized = true;
+
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_RESTORED:
+        case SDL_EVENT_WINDOW_SHOWN: {
+            g_isMinimized = false;
+
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_OCCLUDED: {
+            g_isOccluded = true;
+
+            break;
+        }
+
+        case SDL_EVENT_WINDOW_EXPOSED: {
+            g_isOccluded = false;
+
+            break;
+        }
+
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_WHEEL: {
+            g_lastInput = clock::now();
+
+            break;
+        }
+
+        default: {
+        }
+    }
+}
+
+void update() {
+    const mode_t l_mode = desiredMode();
+
+    if ( l_mode == g_mode ) {
+        return;
+    }
+
+    log::debug( "Frame rate governor: {} -> {}", name( g_mode ),
+                name( l_mode ) );
+
+    g_mode = l_mode;
+
+    vsync::setDesiredFPS( desiredFPS( l_mode ) );
+}
+
+auto mode() -> mode_t {
+    return ( g_mode );
+}
+
+auto name( mode_t _mode ) -> std::string_view {
+    std::string_view l_returnValue = "unknown";
+
+    switch ( _mode ) {
+        case mode_t::active: {
+            l_returnValue = "active";
+
+            break;
+        }
+
+        case mode_t::idle: {
+            l_returnValue = "idle";
+
+            break;
+        }
+
+        case mode_t::background: {
+            l_returnValue = "background";
+
+            break;
+        }
+
+        case mode_t::hidden: {
+            l_returnValue = "hidden";
+
+            break;
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace governor
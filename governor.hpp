@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+// Frame rate governor
+// Lowers vsync target when window is unfocused or input is idle, and lets
+// game loop block on events while nobody can see the window
+namespace governor {
+
+enum class mode_t : uint8_t {
+    active = 0,
+    // No input for a while
+    idle,
+    // Visible but unfocused
+    background,
+    // Minimized, hidden or occluded, frames only on events or timeout
+    hidden,
+};
+
+inline constexpr const float g_idleFPS = 30;
+inline constexpr const float g_backgroundFPS = 15;
+inline constexpr const std::chrono::seconds g_idleTimeout{ 10 };
+// Longest wait for events while hidden
+inline constexpr const int32_t g_hiddenWaitMilliseconds = 250;
+
+auto init( float _activeFPS ) -> bool;
+void quit();
+
+void event( const SDL_Event& _event );
+
+// Once per frame after events, retargets vsync on mode change
+void update();
+
+auto mode() -> mode_t;
+
+auto name( mode_t _mode ) -> std::string_view;
+
+} // namespace governor
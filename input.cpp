@@ -0,0 +1,230 @@
+#include "input.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+namespace input {
+
+namespace {
+
+auto isSame( const controls::input_t& _lhs, const controls::input_t& _rhs )
+    -> bool {
+    return ( ( _lhs.direction == _rhs.direction ) &&
+             ( _lhs.button == _rhs.button ) );
+}
+
+auto isMatching( const step_t& _step,
+                 const controls::input_t& _previous,
+                 const controls::input_t& _input ) -> bool {
+    using controls::button_t;
+    using controls::direction_t;
+    using buttonType_t = std::underlying_type_t< button_t >;
+
+    const bool l_isDirectionMatching =
+        ( ( _step.direction == direction_t::none ) ||
+          ( _step.direction == _input.direction ) );
+
+    const auto l_pressed = static_cast< button_t >(
+        static_cast< buttonType_t >( _input.button ) &
+        ~static_cast< buttonType_t >( _previous.button ) );
+
+    return ( l_isDirectionMatching &&
+             ( ( l_pressed & _step.button ) == _step.button ) );
+}
+
+auto toCommand( std::initializer_list< step_t > _steps,
+                uint64_t _windowTicks ) -> command_t {
+    command_t l_returnValue;
+
+    for ( const step_t& l_step : _steps ) {
+        l_returnValue.steps[ l_returnValue.stepCount++ ] = l_step;
+    }
+
+    l_returnValue.windowTicks = _windowTicks;
+
+    return ( l_returnValue );
+}
+
+auto toStep( controls::direction_t _direction,
+             controls::button_t _button = controls::button_t::none )
+    -> step_t {
+    step_t l_returnValue;
+
+    l_returnValue.direction = _direction;
+    l_returnValue.button = _button;
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto defaultCommands() -> std::vector< command_t > {
+    using controls::button_t;
+    using controls::direction_t;
+
+    // 1 kHz ticks
+    constexpr uint64_t l_motionWindowTicks = 300;
+
+    const std::vector< command_t > l_returnValue = {
+        // Quarter circle forward
+        toCommand( { toStep( direction_t::down ),
+                     toStep( direction_t::down | direction_t::right ),
+                     toStep( direction_t::right ),
+                     toStep( direction_t::none, button_t::a ) },
+                   l_motionWindowTicks ),
+        // Quarter circle back
+        toCommand( { toStep( direction_t::down ),
+                     toStep( direction_t::down | direction_t::left ),
+                     toStep( direction_t::left ),
+                     toStep( direction_t::none, button_t::a ) },
+                   l_motionWindowTicks ),
+        // Dragon punch
+        toCommand( { toStep( direction_t::right ), toStep( direction_t::down ),
+                     toStep( direction_t::down | direction_t::right ),
+                     toStep( direction_t::none, button_t::a ) },
+                   l_motionWindowTicks ),
+    };
+
+    return ( l_returnValue );
+}
+
+auto history_t::push( const controls::input_t& _input, size_t _ticks )
+    -> bool {
+    bool l_returnValue = false;
+
+    if ( end && isSame( runs[ ( end - 1 ) % g_historyCapacity ], _input ) ) {
+        runs[ ( end - 1 ) % g_historyCapacity ].duration += _ticks;
+
+    } else {
+        controls::input_t& l_run = runs[ end % g_historyCapacity ];
+
+        l_run = _input;
+        l_run.duration = _ticks;
+
+        end++;
+
+        l_returnValue = true;
+    }
+
+    return ( l_returnValue );
+}
+
+auto history_t::at( size_t _age ) const -> const controls::input_t& {
+    return ( runs[ ( end - 1 - _age ) % g_historyCapacity ] );
+}
+
+auto history_t::size() const -> size_t {
+    return ( std::min( end, g_historyCapacity ) );
+}
+
+auto matcher_t::feed( const command_t& _command,
+                      const controls::input_t& _previous,
+                      const controls::input_t& _input,
+                      uint64_t _tick ) -> bool {
+    bool l_returnValue = false;
+
+    // Last step first, so one input never advances two steps
+    for ( size_t l_step = _command.stepCount; l_step--; ) {
+        if ( !isMatching( _command.steps[ l_step ], _previous, _input ) ) {
+            continue;
+        }
+
+        uint64_t l_start = _tick;
+
+        if ( l_step ) {
+            if ( !( valid & ( 1U << l_step ) ) ) {
+                continue;
+            }
+
+            l_start = starts[ l_step ];
+
+            if ( ( _tick - l_start ) > _command.windowTicks ) {
+                valid &= ~( 1U << l_step );
+
+                continue;
+            }
+        }
+
+        if ( ( l_step + 1 ) == _command.stepCount ) {
+            // Next attempt starts from scratch
+            valid = 0;
+
+            l_returnValue = true;
+
+            break;
+        }
+
+        // Starts only grow, so latest partial match replaces older one
+        starts[ l_step + 1 ] = l_start;
+        valid |= ( 1U << ( l_step + 1 ) );
+    }
+
+    return ( l_returnValue );
+}
+
+auto player_t::add( const command_t& _command ) -> size_t {
+    commands.push_back( _command );
+    matchers.emplace_back();
+
+    return ( commands.size() - 1 );
+}
+
+void player_t::key( SDL_Scancode _scancode,
+                    bool _isPressed,
+                    uint64_t _timestamp ) {
+    const auto l_scancode = static_cast< size_t >( _scancode );
+
+    if ( !table || ( l_scancode >= keys.size() ) ) {
+        return;
+    }
+
+    advance( _timestamp );
+
+    keys[ l_scancode ] = _isPressed;
+
+    const controls::input_t l_input = table->sample( keys );
+
+    if ( isSame( l_input, current ) ) {
+        return;
+    }
+
+    const controls::input_t l_recorded =
+        ( history.size() ? history.at( 0 ) : controls::input_t{} );
+
+    // Changed earlier in this tick and not recorded yet, e.g. a tap
+    if ( !isSame( l_recorded, current ) ) {
+        advance( ( tick + 1 ) * g_tickNanoseconds );
+    }
+
+    current = l_input;
+}
+
+void player_t::advance( uint64_t _timestamp ) {
+    const uint64_t l_tick = ( _timestamp / g_tickNanoseconds );
+
+    if ( !tick ) {
+        tick = l_tick;
+    }
+
+    if ( l_tick <= tick ) {
+        return;
+    }
+
+    const controls::input_t l_previous =
+        ( history.size() ? history.at( 0 ) : controls::input_t{} );
+
+    if ( history.push( current, ( l_tick - tick ) ) ) {
+        for ( size_t l_command = 0; l_command < commands.size();
+              l_command++ ) {
+            if ( matchers[ l_command ].feed( commands[ l_command ],
+                                             l_previous, current, tick ) ) {
+                completed.push_back( l_command );
+            }
+        }
+    }
+
+    tick = l_tick;
+}
+
+} // namespace input
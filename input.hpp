@@ -0,0 +1,132 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "controls.hpp"
+
+// Input history and motion commands
+// Key events are placed on a fixed tick grid by their SDL timestamps, so
+// history does not depend on frame rate or when events were polled.
+// History keeps runs of unchanged input, duration is their length in ticks
+namespace input {
+
+// 1 kHz, finer than simulation tick
+inline constexpr const uint64_t g_tickNanoseconds = 1'000'000;
+// Input changes kept, not ticks
+inline constexpr const size_t g_historyCapacity = 256;
+inline constexpr const size_t g_maxSteps = 8;
+
+using history_t = struct history {
+    history() = default;
+    history( const history& ) = default;
+    history( history&& ) = default;
+    ~history() = default;
+    auto operator=( const history& ) -> history& = default;
+    auto operator=( history&& ) -> history& = default;
+
+    // Extends newest run when _input did not change, true if a run started
+    auto push( const controls::input_t& _input, size_t _ticks ) -> bool;
+
+    // 0 is newest, its duration still grows
+    [[nodiscard]] auto at( size_t _age ) const -> const controls::input_t&;
+    [[nodiscard]] auto size() const -> size_t;
+
+    std::array< controls::input_t, g_historyCapacity > runs{};
+    // Runs ever pushed, newest is one before
+    size_t end = 0;
+};
+
+// Direction has to match exactly, none matches any direction
+// Buttons have to be pressed on this step, not held from an earlier one
+using step_t = struct step {
+    step() = default;
+    step( const step& ) = default;
+    step( step&& ) = default;
+    ~step() = default;
+    auto operator=( const step& ) -> step& = default;
+    auto operator=( step&& ) -> step& = default;
+
+    controls::direction_t direction = controls::direction_t::none;
+    controls::button_t button = controls::button_t::none;
+};
+
+// Other input may come between steps, e.g. quarter circle forward and A is
+// down, down and right, right, A
+using command_t = struct command {
+    command() = default;
+    command( const command& ) = default;
+    command( command&& ) = default;
+    ~command() = default;
+    auto operator=( const command& ) -> command& = default;
+    auto operator=( command&& ) -> command& = default;
+
+    std::array< step_t, g_maxSteps > steps{};
+    size_t stepCount = 0;
+    // From first to last step
+    uint64_t windowTicks = 0;
+};
+
+// Progress of one command, updated once per input change
+using matcher_t = struct matcher {
+    matcher() = default;
+    matcher( const matcher& ) = default;
+    matcher( matcher&& ) = default;
+    ~matcher() = default;
+    auto operator=( const matcher& ) -> matcher& = default;
+    auto operator=( matcher&& ) -> matcher& = default;
+
+    // Input changed from _previous to _input at _tick, true on completion
+    auto feed( const command_t& _command,
+               const controls::input_t& _previous,
+               const controls::input_t& _input,
+               uint64_t _tick ) -> bool;
+
+    // Tick step 0 matched for latest partial match that completed steps
+    // before index, index 0 is unused
+    std::array< uint64_t, g_maxSteps > starts{};
+    // Bit per starts entry
+    uint8_t valid = 0;
+};
+
+static_assert( g_maxSteps <= 8, "Valid bits do not fit" );
+
+// Quarter circles and dragon punch on A, windows fit a relaxed input
+auto defaultCommands() -> std::vector< command_t >;
+
+using player_t = struct player {
+    player() = default;
+    player( const player& ) = default;
+    player( player&& ) = default;
+    ~player() = default;
+    auto operator=( const player& ) -> player& = default;
+    auto operator=( player&& ) -> player& = default;
+
+    // Returns index reported in completed
+    auto add( const command_t& _command ) -> size_t;
+
+    // Key event at SDL timestamp, earlier ticks keep previous input
+    // Input that changes again within a tick still gets one tick
+    void key( SDL_Scancode _scancode, bool _isPressed, uint64_t _timestamp );
+    // Records ticks up to _timestamp
+    void advance( uint64_t _timestamp );
+
+    // Bindings of this player
+    const controls::table_t* table = nullptr;
+    std::array< bool, controls::g_scancodeCount > keys{};
+    controls::input_t current;
+    history_t history;
+    // Next tick to record, 0 until first event
+    uint64_t tick = 0;
+
+    std::vector< command_t > commands;
+    std::vector< matcher_t > matchers;
+    // Indices of commands completed, in order, consumer clears
+    std::vector< size_t > completed;
+};
+
+} // namespace input
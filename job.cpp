@@ -0,0 +1,453 @@
+#include "job.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "log.hpp"
+#include "queue.hpp"
+
+namespace job {
+
+namespace {
+
+using work_t = struct work {
+    work() = default;
+    work( const work& ) = delete;
+    work( work&& ) = delete;
+    ~work() = default;
+    auto operator=( const work& ) -> work& = delete;
+    auto operator=( work&& ) -> work& = delete;
+
+    task_t task;
+    counter_t* counter = nullptr;
+    // Free list link while pooled
+    work* next = nullptr;
+};
+
+inline constexpr const size_t g_dequeCapacity = 4096;
+inline constexpr const size_t g_injectedCapacity = 4096;
+// Empty rounds a worker spins through before it sleeps
+inline constexpr const size_t g_spinCount = 64;
+// Parallel for splits into this many tasks per thread to balance load
+inline constexpr const size_t g_tasksPerThread = 4;
+inline constexpr const size_t g_external = SIZE_MAX;
+// Recycled work a slot keeps for itself, more goes to shared pool
+inline constexpr const size_t g_pooledPerSlot = 128;
+inline constexpr const size_t g_sharedPoolCapacity = 8192;
+
+using slot_t = struct slot {
+    slot() = default;
+    slot( const slot& ) = delete;
+    slot( slot&& ) = delete;
+    ~slot() = default;
+    auto operator=( const slot& ) -> slot& = delete;
+    auto operator=( slot&& ) -> slot& = delete;
+
+    queue::chaseLev_t< work_t*, g_dequeCapacity > deque;
+
+    alignas( g_cacheLineSize ) std::atomic< size_t > tasks = 0;
+    std::atomic< size_t > steals = 0;
+    std::atomic< size_t > failedSteals = 0;
+    std::atomic< size_t > overflows = 0;
+    std::atomic< size_t > sleeps = 0;
+
+    // Owning thread only
+    work_t* pool = nullptr;
+    size_t pooledCount = 0;
+};
+
+std::vector< std::jthread > g_workerThreads;
+// Initializing thread, then workers, last one counts outside threads
+std::vector< std::unique_ptr< slot_t > > g_slots;
+queue::mpmc_t< work_t*, g_injectedCapacity > g_injected;
+// Overflow of slot pools, outside threads recycle through it alone
+queue::mpmc_t< work_t*, g_sharedPoolCapacity > g_pool;
+
+std::counting_semaphore<> g_wake{ 0 };
+std::atomic< size_t > g_sleeping = 0;
+
+thread_local size_t g_threadSlot = g_external;
+thread_local uint32_t g_random = 1;
+
+auto currentSlot() -> slot_t& {
+    return ( *g_slots[ std::min( g_threadSlot, ( g_slots.size() - 1 ) ) ] );
+}
+
+auto nextRandom() -> uint32_t {
+    // xorshift32
+    g_random ^= ( g_random << 13 );
+    g_random ^= ( g_random >> 17 );
+    g_random ^= ( g_random << 5 );
+
+    return ( g_random );
+}
+
+// Allocates only until pools are warm
+auto acquire() -> work_t* {
+    work_t* l_returnValue = nullptr;
+
+    {
+        if ( g_threadSlot != g_external ) {
+            slot_t& l_slot = currentSlot();
+
+            if ( l_slot.pool ) {
+                l_returnValue = l_slot.pool;
+                l_slot.pool = l_returnValue->next;
+                l_slot.pooledCount--;
+
+                goto EXIT;
+            }
+        }
+
+        if ( g_pool.pop( l_returnValue ) ) {
+            goto EXIT;
+        }
+
+        l_returnValue = new work_t;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+// Thieves release work of other slots, excess flows back through shared pool
+void release( work_t* _work ) {
+    // Captures die with their task, not with the next one
+    _work->task = nullptr;
+    _work->counter = nullptr;
+
+    if ( g_threadSlot != g_external ) {
+        slot_t& l_slot = currentSlot();
+
+        if ( l_slot.pooledCount < g_pooledPerSlot ) {
+            _work->next = l_slot.pool;
+            l_slot.pool = _work;
+            l_slot.pooledCount++;
+
+            return;
+        }
+    }
+
+    if ( !g_pool.push( _work ) ) {
+        delete _work;
+    }
+}
+
+void execute( work_t* _work ) {
+    _work->task();
+
+    // Before release, so waiters read complete statistics
+    currentSlot().tasks.fetch_add( 1, std::memory_order_relaxed );
+
+    if ( _work->counter ) {
+        _work->counter->fetch_sub( 1, std::memory_order_release );
+    }
+
+    release( _work );
+}
+
+// Own deque first, then shared queue, then steals starting at random victim
+auto find( work_t*& _work ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        slot_t& l_slot = currentSlot();
+
+        if ( ( g_threadSlot != g_external ) && l_slot.deque.pop( _work ) ) {
+            l_returnValue = true;
+
+            goto EXIT;
+        }
+
+        if ( g_injected.pop( _work ) ) {
+            l_returnValue = true;
+
+            goto EXIT;
+        }
+
+        const size_t l_victimCount = ( g_slots.size() - 1 );
+        const size_t l_first = ( nextRandom() % l_victimCount );
+
+        for ( size_t l_index = 0; l_index < l_victimCount; l_index++ ) {
+            const size_t l_victim = ( ( l_first + l_index ) % l_victimCount );
+
+            if ( l_victim == g_threadSlot ) {
+                continue;
+            }
+
+            using steal_t = decltype( l_slot.deque )::steal_t;
+
+            const steal_t l_result = g_slots[ l_victim ]->deque.steal( _work );
+
+            if ( l_result == steal_t::success ) {
+                l_slot.steals.fetch_add( 1, std::memory_order_relaxed );
+
+                l_returnValue = true;
+
+                goto EXIT;
+            }
+
+            if ( l_result == steal_t::contended ) {
+                l_slot.failedSteals.fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void wake() {
+    // Pairs with sleeping worker checking for work after announcing itself
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    if ( g_sleeping.load( std::memory_order_relaxed ) ) {
+        g_wake.release();
+    }
+}
+
+void worker( const std::stop_token& _stopToken, size_t _slot ) {
+    g_threadSlot = _slot;
+    g_random = static_cast< uint32_t >( _slot + 1 );
+
+    size_t l_idleRounds = 0;
+    work_t* l_work = nullptr;
+
+    while ( !_stopToken.stop_requested() ) {
+        if ( find( l_work ) ) {
+            execute( l_work );
+
+            l_idleRounds = 0;
+
+            continue;
+        }
+
+        if ( ++l_idleRounds < g_spinCount ) {
+            std::this_thread::yield();
+
+            continue;
+        }
+
+        l_idleRounds = 0;
+
+        g_sleeping.fetch_add( 1, std::memory_order_seq_cst );
+
+        // Work pushed before producer saw this sleeper
+        if ( find( l_work ) ) {
+            g_sleeping.fetch_sub( 1, std::memory_order_relaxed );
+
+            execute( l_work );
+
+            continue;
+        }
+
+        currentSlot().sleeps.fetch_add( 1, std::memory_order_relaxed );
+
+        g_wake.acquire();
+
+        g_sleeping.fetch_sub( 1, std::memory_order_relaxed );
+    }
+}
+
+} // namespace
+
+auto init( size_t _threadCount ) -> bool {
+    log::variable( _threadCount );
+
+    bool l_returnValue = false;
+
+    {
+        if ( !g_slots.empty() ) {
+            log::error( "Already initialized" );
+
+            goto EXIT;
+        }
+
+        g_slots.resize( _threadCount + 2 );
+
+        for ( std::unique_ptr< slot_t >& l_slot : g_slots ) {
+            l_slot = std::make_unique< slot_t >();
+        }
+
+        g_threadSlot = 0;
+
+        g_workerThreads.reserve( _threadCount );
+
+        for ( size_t l_index = 0; l_index < _threadCount; l_index++ ) {
+            g_workerThreads.emplace_back( worker, ( l_index + 1 ) );
+        }
+
+        log::info( "Started {} job worker threads", _threadCount );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void quit() {
+    if ( g_slots.empty() ) {
+        return;
+    }
+
+    for ( std::jthread& l_thread : g_workerThreads ) {
+        l_thread.request_stop();
+    }
+
+    g_wake.release( g_workerThreads.size() );
+
+    g_workerThreads.clear();
+
+    // Leftovers run here, so no counter stays raised
+    {
+        work_t* l_work = nullptr;
+
+        while ( find( l_work ) ) {
+            execute( l_work );
+        }
+    }
+
+    for ( const std::unique_ptr< slot_t >& l_slot : g_slots ) {
+        while ( l_slot->pool ) {
+            work_t* l_next = l_slot->pool->next;
+
+            delete l_slot->pool;
+
+            l_slot->pool = l_next;
+        }
+    }
+
+    {
+        work_t* l_work = nullptr;
+
+        while ( g_pool.pop( l_work ) ) {
+            delete l_work;
+        }
+    }
+
+    g_slots.clear();
+
+    g_threadSlot = g_external;
+}
+
+auto threadCount() -> size_t {
+    return ( g_workerThreads.size() );
+}
+
+void run( task_t _task, counter_t* _counter ) {
+    if ( _counter ) {
+        _counter->fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    // Not started, nothing to schedule on
+    if ( g_slots.empty() ) {
+        _task();
+
+        if ( _counter ) {
+            _counter->fetch_sub( 1, std::memory_order_release );
+        }
+
+        return;
+    }
+
+    work_t* l_work = acquire();
+
+    l_work->task = std::move( _task );
+    l_work->counter = _counter;
+
+    const bool l_isQueued =
+        ( ( g_threadSlot != g_external )
+              ? currentSlot().deque.push( l_work )
+              : g_injected.push( l_work ) );
+
+    if ( !l_isQueued ) {
+        currentSlot().overflows.fetch_add( 1, std::memory_order_relaxed );
+
+        execute( l_work );
+
+        return;
+    }
+
+    wake();
+}
+
+void wait( const counter_t& _counter ) {
+    work_t* l_work = nullptr;
+
+    while ( _counter.load( std::memory_order_acquire ) ) {
+        if ( !g_slots.empty() && find( l_work ) ) {
+            execute( l_work );
+
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void parallelFor( size_t _count, const job_t& _job ) {
+    const size_t l_taskCount = std::min(
+        _count, ( ( g_workerThreads.size() + 1 ) * g_tasksPerThread ) );
+
+    auto l_range = [ & ]( size_t _task ) {
+        const size_t l_end = ( ( _count * ( _task + 1 ) ) / l_taskCount );
+
+        for ( size_t l_index = ( ( _count * _task ) / l_taskCount );
+              l_index < l_end; l_index++ ) {
+            _job( l_index );
+        }
+    };
+
+    if ( l_taskCount <= 1 ) {
+        for ( size_t l_index = 0; l_index < _count; l_index++ ) {
+            _job( l_index );
+        }
+
+        return;
+    }
+
+    counter_t l_counter = 0;
+
+    for ( size_t l_task = 1; l_task < l_taskCount; l_task++ ) {
+        run( [ &l_range, l_task ]() { l_range( l_task ); }, &l_counter );
+    }
+
+    // Calling thread takes first share itself
+    l_range( 0 );
+
+    wait( l_counter );
+}
+
+auto statistics() -> statistics_t {
+    statistics_t l_returnValue;
+
+    for ( const std::unique_ptr< slot_t >& l_slot : g_slots ) {
+        l_returnValue.tasks += l_slot->tasks.load( std::memory_order_relaxed );
+        l_returnValue.steals +=
+            l_slot->steals.load( std::memory_order_relaxed );
+        l_returnValue.failedSteals +=
+            l_slot->failedSteals.load( std::memory_order_relaxed );
+        l_returnValue.overflows +=
+            l_slot->overflows.load( std::memory_order_relaxed );
+        l_returnValue.sleeps +=
+            l_slot->sleeps.load( std::memory_order_relaxed );
+    }
+
+    return ( l_returnValue );
+}
+
+void resetStatistics() {
+    for ( const std::unique_ptr< slot_t >& l_slot : g_slots ) {
+        l_slot->tasks.store( 0, std::memory_order_relaxed );
+        l_slot->steals.store( 0, std::memory_order_relaxed );
+        l_slot->failedSteals.store( 0, std::memory_order_relaxed );
+        l_slot->overflows.store( 0, std::memory_order_relaxed );
+        l_slot->sleeps.store( 0, std::memory_order_relaxed );
+    }
+}
+
+} // namespace job
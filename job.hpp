@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+// Work-stealing task scheduler
+// Every thread owns a Chase-Lev deque, idle threads steal from the others.
+// Threads outside the scheduler submit through a shared queue
+namespace job {
+
+using task_t = std::function< void() >;
+// Runs on worker or calling thread, once per index
+using job_t = std::function< void( size_t _index ) >;
+
+// Unfinished tasks, dependents wait for zero
+using counter_t = std::atomic< size_t >;
+
+using statistics_t = struct statistics {
+    statistics() = default;
+    statistics( const statistics& ) = default;
+    statistics( statistics&& ) = default;
+    ~statistics() = default;
+    auto operator=( const statistics& ) -> statistics& = default;
+    auto operator=( statistics&& ) -> statistics& = default;
+
+    size_t tasks = 0;
+    size_t steals = 0;
+    // Lost race against victim or another thief
+    size_t failedSteals = 0;
+    // Tasks that ran inline because their deque was full
+    size_t overflows = 0;
+    size_t sleeps = 0;
+};
+
+// Calling thread becomes part of the scheduler
+auto init( size_t _threadCount ) -> bool;
+void quit();
+
+// Worker threads, calling thread is not counted
+auto threadCount() -> size_t;
+
+// Increments _counter now and decrements it when _task finished
+// Work items are pooled, captures of up to two pointers make run allocate
+// nothing once warm
+void run( task_t _task, counter_t* _counter = nullptr );
+
+// Runs other tasks until _counter reaches zero, so tasks may wait on their
+// own children
+void wait( const counter_t& _counter );
+
+// Runs _job for every index in [ 0, _count ), returns when all finished
+// Calling thread takes part, nests inside tasks
+void parallelFor( size_t _count, const job_t& _job );
+
+// Summed over all threads since init or last reset
+auto statistics() -> statistics_t;
+void resetStatistics();
+
+} // namespace job
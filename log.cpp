@@ -0,0 +1,445 @@
+#include "log.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "queue.hpp"
+
+namespace log {
+
+namespace {
+
+// Prefixes
+inline constexpr const std::string_view g_logDebugPrefix = "DEBUG: ";
+inline constexpr const std::string_view g_logInfoPrefix = "INFO: ";
+inline constexpr const std::string_view g_logWarningPrefix = "WARNING: ";
+inline constexpr const std::string_view g_logErrorPrefix = "ERROR: ";
+
+// Writer sleeps this long once queue is empty
+inline constexpr const std::chrono::milliseconds g_writerIdle{ 1 };
+// File sink calls write(2) once this much is buffered
+inline constexpr const size_t g_fileBufferSize = 65536;
+
+queue::mpmc_t< record_t, g_queueCapacity > g_queue;
+std::atomic< bool > g_isAsynchronous = false;
+std::atomic< size_t > g_dropped = 0;
+
+std::vector< sink_t > g_sinks;
+
+std::jthread g_writerThread;
+
+// Written by whoever runs sinks, read by crash handler
+std::array< char, g_ringSize > g_ring{};
+std::atomic< size_t > g_ringPosition = 0;
+
+using fileState_t = struct fileState {
+    fileState() = default;
+    fileState( const fileState& ) = delete;
+    fileState( fileState&& ) = delete;
+    ~fileState() {
+        flush();
+
+        if ( fileDescriptor != -1 ) {
+            close( fileDescriptor );
+        }
+    }
+    auto operator=( const fileState& ) -> fileState& = delete;
+    auto operator=( fileState&& ) -> fileState& = delete;
+
+    void flush() {
+        size_t l_written = 0;
+
+        while ( l_written < buffer.size() ) {
+            const ssize_t l_result =
+                ::write( fileDescriptor, ( buffer.data() + l_written ),
+                         ( buffer.size() - l_written ) );
+
+            if ( l_result <= 0 ) {
+                break;
+            }
+
+            l_written += l_result;
+        }
+
+        buffer.clear();
+    }
+
+    int fileDescriptor = -1;
+    std::string buffer;
+};
+
+auto prefix( level_t _level ) -> std::string_view {
+    std::string_view l_returnValue;
+
+    switch ( _level ) {
+        case level_t::debug: {
+            l_returnValue = g_logDebugPrefix;
+
+            break;
+        }
+
+        case level_t::info: {
+            l_returnValue = g_logInfoPrefix;
+
+            break;
+        }
+
+        case level_t::warning: {
+            l_returnValue = g_logWarningPrefix;
+
+            break;
+        }
+
+        default: {
+            l_returnValue = g_logErrorPrefix;
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+void crashHandler( int _signal ) {
+    dumpRing( STDERR_FILENO );
+
+    std::signal( _signal, SIG_DFL );
+    std::raise( _signal );
+}
+
+// Writer thread, or calling thread when writer is not running
+void output( const record_t& _record, std::string& _buffer ) {
+    std::string_view l_message( _record.text.data(), _record.size );
+
+    if ( _record.formatter ) {
+        _buffer.clear();
+
+        _record.formatter( _record.format,
+                           reinterpret_cast< const std::byte* >(
+                               _record.text.data() ),
+                           _buffer );
+
+        l_message = _buffer;
+    }
+
+    if ( g_sinks.empty() ) {
+        g_sinks.push_back( console() );
+    }
+
+    for ( const sink_t& l_sink : g_sinks ) {
+        l_sink.write( _record.level, _record.category, l_message );
+    }
+}
+
+void flush() {
+    for ( const sink_t& l_sink : g_sinks ) {
+        if ( l_sink.flush ) {
+            l_sink.flush();
+        }
+    }
+}
+
+// Drains queue, returns amount written
+auto drain( std::string& _buffer ) -> size_t {
+    size_t l_returnValue = 0;
+
+    record_t l_record;
+
+    while ( g_queue.pop( l_record ) ) {
+        output( l_record, _buffer );
+
+        l_returnValue++;
+    }
+
+    return ( l_returnValue );
+}
+
+void writer( const std::stop_token& _stopToken ) {
+    std::string l_buffer;
+    size_t l_reportedDropped = 0;
+
+    l_buffer.reserve( g_recordTextSize );
+
+    while ( !_stopToken.stop_requested() ) {
+        if ( drain( l_buffer ) ) {
+            continue;
+        }
+
+        const size_t l_dropped = g_dropped.load( std::memory_order_relaxed );
+
+        if ( l_dropped != l_reportedDropped ) {
+            record_t l_record;
+
+            l_record.level = level_t::warning;
+            l_record.size = static_cast< uint16_t >(
+                std::format_to_n( l_record.text.data(), l_record.text.size(),
+                                  "Dropped {} log records",
+                                  ( l_dropped - l_reportedDropped ) )
+                    .size );
+
+            output( l_record, l_buffer );
+
+            l_reportedDropped = l_dropped;
+        }
+
+        flush();
+
+        std::this_thread::sleep_for( g_writerIdle );
+    }
+}
+
+} // namespace
+
+auto name( level_t _level ) -> std::string_view {
+    std::string_view l_returnValue = "unknown";
+
+    switch ( _level ) {
+        case level_t::debug: {
+            l_returnValue = "debug";
+
+            break;
+        }
+
+        case level_t::info: {
+            l_returnValue = "info";
+
+            break;
+        }
+
+        case level_t::warning: {
+            l_returnValue = "warning";
+
+            break;
+        }
+
+        case level_t::error: {
+            l_returnValue = "error";
+
+            break;
+        }
+
+        default: {
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto name( category_t _category ) -> std::string_view {
+    std::string_view l_returnValue = "unknown";
+
+    switch ( _category ) {
+        case category_t::general: {
+            l_returnValue = "general";
+
+            break;
+        }
+
+        case category_t::frame: {
+            l_returnValue = "frame";
+
+            break;
+        }
+
+        case category_t::renderer: {
+            l_returnValue = "renderer";
+
+            break;
+        }
+
+        case category_t::stream: {
+            l_returnValue = "stream";
+
+            break;
+        }
+
+        case category_t::job: {
+            l_returnValue = "job";
+
+            break;
+        }
+
+        default: {
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto console() -> sink_t {
+    sink_t l_returnValue;
+
+    l_returnValue.write = []( level_t _level, category_t,
+                              std::string_view _message ) {
+        std::ostream& l_stream =
+            ( ( _level >= level_t::warning ) ? ( std::cerr ) : ( std::cout ) );
+
+        l_stream << prefix( _level ) << _message << "\n";
+    };
+
+    l_returnValue.flush = [] { std::cout.flush(); };
+
+    return ( l_returnValue );
+}
+
+auto file( std::string_view _path, sink_t& _sink ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        auto l_file = std::make_shared< fileState_t >();
+
+        l_file->fileDescriptor =
+            open( std::string( _path ).c_str(),
+                  ( O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC ), 0644 );
+
+        if ( l_file->fileDescriptor == -1 ) {
+            log::error( std::format( "Opening '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        l_file->buffer.reserve( g_fileBufferSize );
+
+        const auto l_epoch = std::chrono::steady_clock::now();
+
+        // Seconds since sink creation, level, category, message
+        _sink.write = [ l_file, l_epoch ]( level_t _level,
+                                           category_t _category,
+                                           std::string_view _message ) {
+            const std::chrono::duration< double > l_time =
+                ( std::chrono::steady_clock::now() - l_epoch );
+
+            std::format_to( std::back_inserter( l_file->buffer ),
+                            "{:.6f} {} {} | {}\n", l_time.count(),
+                            name( _level ), name( _category ), _message );
+
+            if ( l_file->buffer.size() >= g_fileBufferSize ) {
+                l_file->flush();
+            }
+        };
+
+        _sink.flush = [ l_file ] { l_file->flush(); };
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+auto ring() -> sink_t {
+    sink_t l_returnValue;
+
+    l_returnValue.write = []( level_t _level, category_t,
+                              std::string_view _message ) {
+        size_t l_position = g_ringPosition.load( std::memory_order_relaxed );
+
+        for ( const std::string_view l_part :
+              { prefix( _level ), _message, std::string_view( "\n" ) } ) {
+            for ( const char l_character : l_part ) {
+                g_ring[ l_position % g_ringSize ] = l_character;
+
+                l_position++;
+            }
+        }
+
+        g_ringPosition.store( l_position, std::memory_order_release );
+    };
+
+    std::signal( SIGSEGV, crashHandler );
+    std::signal( SIGABRT, crashHandler );
+    std::signal( SIGBUS, crashHandler );
+    std::signal( SIGFPE, crashHandler );
+    std::signal( SIGILL, crashHandler );
+
+    return ( l_returnValue );
+}
+
+void dumpRing( int _fileDescriptor ) {
+    const size_t l_position = g_ringPosition.load( std::memory_order_acquire );
+
+    // Oldest part first once ring wrapped
+    if ( l_position > g_ringSize ) {
+        const size_t l_start = ( l_position % g_ringSize );
+
+        ( void )!::write( _fileDescriptor, ( g_ring.data() + l_start ),
+                          ( g_ringSize - l_start ) );
+        ( void )!::write( _fileDescriptor, g_ring.data(), l_start );
+
+    } else {
+        ( void )!::write( _fileDescriptor, g_ring.data(), l_position );
+    }
+}
+
+void addSink( sink_t _sink ) {
+    if ( g_isAsynchronous ) {
+        log::error( "Sinks have to be added before init" );
+
+        return;
+    }
+
+    g_sinks.push_back( std::move( _sink ) );
+}
+
+void init() {
+    if ( g_isAsynchronous ) {
+        return;
+    }
+
+    if ( g_sinks.empty() ) {
+        g_sinks.push_back( console() );
+    }
+
+    g_writerThread = std::jthread( writer );
+
+    g_isAsynchronous = true;
+}
+
+void quit() {
+    if ( !g_isAsynchronous ) {
+        return;
+    }
+
+    g_isAsynchronous = false;
+
+    g_writerThread.request_stop();
+    g_writerThread.join();
+
+    // Pushed while writer was stopping
+    std::string l_buffer;
+
+    drain( l_buffer );
+
+    flush();
+
+    // Closes files, later records go to console
+    g_sinks.clear();
+}
+
+auto dropped() -> size_t {
+    return ( g_dropped.load( std::memory_order_relaxed ) );
+}
+
+void _write( const record_t& _record ) {
+    if ( !g_isAsynchronous.load( std::memory_order_relaxed ) ) {
+        // Rare, not worth keeping a buffer per thread
+        std::string l_buffer;
+
+        output( _record, l_buffer );
+
+        return;
+    }
+
+    // Never waits for terminal
+    if ( !g_queue.push( _record ) ) {
+        g_dropped.fetch_add( 1, std::memory_order_relaxed );
+    }
+}
+
+} // namespace log
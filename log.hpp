@@ -1,45 +1,265 @@
 #pragma once
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <new>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "common.hpp"
 
-namespace {
+// Lowest level compiled in, 0 debug up to 3 error
+#if !defined( LOG_LEVEL )
 
-// Prefixes
 #if defined( DEBUG )
 
-inline constexpr const std::string_view g_logDebugPrefix = "DEBUG: ";
+#define LOG_LEVEL 0
 
-#endif
+#else
 
-inline constexpr const std::string_view g_logInfoPrefix = "INFO: ";
-inline constexpr const std::string_view g_logWarningPrefix = "WARNING: ";
-inline constexpr const std::string_view g_logErrorPrefix = "ERROR: ";
+#define LOG_LEVEL 1
 
-} // namespace
+#endif
 
+#endif
+
+// Asynchronous logging
+// Calls are filtered by level and category before anything is formatted,
+// then format into a per-thread record and push it through a lock-free
+// queue. Writer thread hands records to every sink. Before init and after
+// quit records go to sinks on the calling thread
 namespace log {
 
+enum class level_t : uint8_t {
+    debug = 0,
+    info,
+    warning,
+    error,
+    // Filter only, disables category
+    off,
+};
+
+enum class category_t : uint8_t {
+    general = 0,
+    // Per-frame statistics and FPS reports
+    frame,
+    renderer,
+    stream,
+    job,
+    count,
+};
+
+inline constexpr const level_t g_minimumLevel =
+    static_cast< level_t >( LOG_LEVEL );
+
+// Longer messages are truncated
+inline constexpr const size_t g_recordTextSize = 224;
+inline constexpr const size_t g_queueCapacity = 4096;
+// Memory ring sink keeps this many most recent bytes
+inline constexpr const size_t g_ringSize = 65536;
+
+// Formats deferred arguments on writer thread
+using formatter_t = void ( * )( std::string_view _format,
+                                const std::byte* _arguments,
+                                std::string& _output );
+
+using record_t = struct record {
+    record() = default;
+    record( const record& ) = default;
+    record( record&& ) = default;
+    ~record() = default;
+    auto operator=( const record& ) -> record& = default;
+    auto operator=( record&& ) -> record& = default;
+
+    level_t level = level_t::info;
+    category_t category = category_t::general;
+    uint16_t size = 0;
+    // Deferred records only, text holds arguments instead
+    formatter_t formatter = nullptr;
+    std::string_view format;
+    alignas( std::max_align_t ) std::array< char, g_recordTextSize > text;
+};
+
+// Gets every record that passed filters, message has no prefix
+using sink_t = struct sink {
+    sink() = default;
+    sink( const sink& ) = default;
+    sink( sink&& ) = default;
+    ~sink() = default;
+    auto operator=( const sink& ) -> sink& = default;
+    auto operator=( sink&& ) -> sink& = default;
+
+    std::function< void( level_t _level,
+                         category_t _category,
+                         std::string_view _message ) >
+        write;
+    // Writer found queue empty
+    std::function< void() > flush;
+};
+
+// Runtime minimum per category, on top of g_minimumLevel
+inline std::array< std::atomic< level_t >,
+                   static_cast< size_t >( category_t::count ) >
+    g_categoryLevels{};
+
+inline void setLevel( category_t _category, level_t _level ) {
+    g_categoryLevels[ static_cast< size_t >( _category ) ].store(
+        _level, std::memory_order_relaxed );
+}
+
+inline auto isEnabled( level_t _level, category_t _category ) -> bool {
+    return ( ( _level >= g_minimumLevel ) &&
+             ( _level >= g_categoryLevels[ static_cast< size_t >( _category ) ]
+                             .load( std::memory_order_relaxed ) ) );
+}
+
+auto name( level_t _level ) -> std::string_view;
+auto name( category_t _category ) -> std::string_view;
+
+// stdout below warning, stderr from warning on
+auto console() -> sink_t;
+// Buffered write(2) to _path, false if it cannot be opened
+auto file( std::string_view _path, sink_t& _sink ) -> bool;
+// Most recent output in memory, dumped to stderr on fatal signals
+auto ring() -> sink_t;
+// Async signal safe
+void dumpRing( int _fileDescriptor );
+
+// Before init only, console is used if none was added
+void addSink( sink_t _sink );
+
+// Starts writer thread
+void init();
+// Writes everything queued, stops writer thread and releases sinks
+void quit();
+
+// Records lost to a full queue
+auto dropped() -> size_t;
+
+// Queues _record, or writes it right away when writer is not running
+void _write( const record_t& _record );
+
+// Formatting scratch of calling thread
+inline thread_local record_t g_record;
+
+inline void _text( level_t _level,
+                   category_t _category,
+                   const std::string_view _message ) {
+    record_t& l_record = g_record;
+
+    l_record.level = _level;
+    l_record.category = _category;
+    l_record.formatter = nullptr;
+    l_record.size = static_cast< uint16_t >(
+        std::min( _message.size(), l_record.text.size() ) );
+
+    std::copy_n( _message.data(), l_record.size, l_record.text.data() );
+
+    _write( l_record );
+}
+
+template < typename... Args >
+inline void _formatted( level_t _level,
+                        category_t _category,
+                        std::format_string< Args... > _format,
+                        Args&&... _arguments ) {
+    record_t& l_record = g_record;
+
+    l_record.level = _level;
+    l_record.category = _category;
+    l_record.formatter = nullptr;
+
+    const auto l_result = std::format_to_n(
+        l_record.text.data(), l_record.text.size(), _format,
+        std::forward< Args >( _arguments )... );
+
+    l_record.size = static_cast< uint16_t >( std::min(
+        static_cast< size_t >( l_result.size ), l_record.text.size() ) );
+
+    _write( l_record );
+}
+
+template < typename... Args >
+void _formatDeferred( std::string_view _format,
+                      const std::byte* _arguments,
+                      std::string& _output ) {
+    std::apply(
+        [ & ]( const Args&... _values ) {
+            std::vformat_to( std::back_inserter( _output ), _format,
+                             std::make_format_args( _values... ) );
+        },
+        *std::launder(
+            reinterpret_cast< const std::tuple< Args... >* >( _arguments ) ) );
+}
+
+// Compiled out below g_minimumLevel, nothing is formatted when filtered
+template < level_t Level >
+inline void _filtered( category_t _category,
+                       const std::string_view _message ) {
+    if constexpr ( Level >= g_minimumLevel ) {
+        if ( isEnabled( Level, _category ) ) {
+            _text( Level, _category, _message );
+        }
+    }
+}
+
+template < level_t Level, typename... Args >
+inline void _filtered( category_t _category,
+                       std::format_string< Args... > _format,
+                       Args&&... _arguments ) {
+    if constexpr ( Level >= g_minimumLevel ) {
+        if ( isEnabled( Level, _category ) ) {
+            _formatted( Level, _category, _format,
+                        std::forward< Args >( _arguments )... );
+        }
+    }
+}
+
+// Every level takes an optional category, then a message or a format with
+// arguments
 inline void debug( const std::string_view _message ) {
-#if defined( DEBUG )
+    _filtered< level_t::debug >( category_t::general, _message );
+}
 
-    std::cout << g_logDebugPrefix << _message << "\n";
+inline void debug( category_t _category, const std::string_view _message ) {
+    _filtered< level_t::debug >( _category, _message );
+}
 
-#endif
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void debug( std::format_string< Args... > _format,
+                   Args&&... _arguments ) {
+    _filtered< level_t::debug >( category_t::general, _format,
+                                 std::forward< Args >( _arguments )... );
+}
+
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void debug( category_t _category,
+                   std::format_string< Args... > _format,
+                   Args&&... _arguments ) {
+    _filtered< level_t::debug >( _category, _format,
+                                 std::forward< Args >( _arguments )... );
 }
 
 template < typename T >
 inline void _variable( const std::string_view _message, const T& _variable ) {
-    std::ostringstream l_stream;
-
-    l_stream << _message << " = '" << _variable << "'";
+    // Only void pointers are formattable
+    if constexpr ( std::is_pointer_v< T > ) {
+        debug( "{} = '{}'", _message,
+               static_cast< const void* >( _variable ) );
 
-    const std::string l_message = l_stream.str();
-
-    debug( l_message );
+    } else {
+        debug( "{} = '{}'", _message, _variable );
+    }
 }
 
 #define variable( _variableToLog )                                    \
@@ -48,11 +268,83 @@ inline void _variable( const std::string_view _message, const T& _variable ) {
                _variableToLog );
 
 inline void info( const std::string_view _message ) {
-    std::cout << g_logInfoPrefix << _message << "\n";
+    _filtered< level_t::info >( category_t::general, _message );
+}
+
+inline void info( category_t _category, const std::string_view _message ) {
+    _filtered< level_t::info >( _category, _message );
+}
+
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void info( std::format_string< Args... > _format,
+                  Args&&... _arguments ) {
+    _filtered< level_t::info >( category_t::general, _format,
+                                std::forward< Args >( _arguments )... );
+}
+
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void info( category_t _category,
+                  std::format_string< Args... > _format,
+                  Args&&... _arguments ) {
+    _filtered< level_t::info >( _category, _format,
+                                std::forward< Args >( _arguments )... );
 }
 
 inline void warning( const std::string_view _message ) {
-    std::cerr << g_logWarningPrefix << _message << "\n";
+    _filtered< level_t::warning >( category_t::general, _message );
+}
+
+inline void warning( category_t _category, const std::string_view _message ) {
+    _filtered< level_t::warning >( _category, _message );
+}
+
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void warning( std::format_string< Args... > _format,
+                     Args&&... _arguments ) {
+    _filtered< level_t::warning >( category_t::general, _format,
+                                   std::forward< Args >( _arguments )... );
+}
+
+template < typename... Args >
+    requires( sizeof...( Args ) > 0 )
+inline void warning( category_t _category,
+                     std::format_string< Args... > _format,
+                     Args&&... _arguments ) {
+    _filtered< level_t::warning >( _category, _format,
+                                   std::forward< Args >( _arguments )... );
+}
+
+// Stores format and arguments, writer thread formats them
+// Arguments are copied by value, so only arithmetic ones are accepted
+template < typename... Args >
+    requires( std::is_arithmetic_v< Args > && ... )
+inline void deferred( level_t _level,
+                      category_t _category,
+                      std::format_string< Args... > _format,
+                      Args... _arguments ) {
+    using arguments_t = std::tuple< Args... >;
+
+    static_assert( sizeof( arguments_t ) <= g_recordTextSize,
+                   "Arguments do not fit record" );
+
+    if ( !isEnabled( _level, _category ) ) {
+        return;
+    }
+
+    record_t& l_record = g_record;
+
+    l_record.level = _level;
+    l_record.category = _category;
+    l_record.size = 0;
+    l_record.formatter = &_formatDeferred< Args... >;
+    l_record.format = _format.get();
+
+    new ( l_record.text.data() ) arguments_t( _arguments... );
+
+    _write( l_record );
 }
 
 // Function file:line | message
@@ -60,8 +352,9 @@ inline void _error( const std::string_view _message,
                     const char* _functionName,
                     const char* _fileName,
                     const char* _lineNumber ) {
-    std::cerr << g_logErrorPrefix << "\"" << _functionName << "\"" << " "
-              << _fileName << ":" << _lineNumber << " | " << _message << "\n";
+    _filtered< level_t::error >( category_t::general, "\"{}\" {}:{} | {}",
+                                 _functionName, _fileName, _lineNumber,
+                                 _message );
 }
 
 #define error( _message )                                     \
@@ -1,12 +1,111 @@
 #include <SDL3/SDL.h>
 #include <bgfx/bgfx.h>
 
+#include <charconv>
+#include <functional>
 #include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
 
+#include "FPS.hpp"
+#include "governor.hpp"
 #include "log.hpp"
+#include "profile.hpp"
+#include "replay.hpp"
+#include "report.hpp"
 #include "runtime.hpp"
 #include "vsync.hpp"
 
+// Render thread checks for game thread exit this often
+static inline constexpr const int32_t g_renderFrameTimeout = 100;
+
+// Headless runs without --frames or --replay stop after this many frames
+static inline constexpr const size_t g_headlessFrameLimit = 1000;
+
+static inline constexpr const std::string_view g_usage =
+    "Usage: main [--record <file> | --replay <file>] [--frames <count>] "
+    "[--vsync off | deadline | lowLatency] [--headless [--report <file>]]";
+
+static auto parseArguments( std::span< char* > _arguments,
+                            runtime::applicationState_t& _applicationState,
+                            replay::mode_t& _replayMode,
+                            std::string_view& _replayPath,
+                            std::string_view& _reportPath ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        for ( size_t l_index = 1; l_index < _arguments.size(); l_index++ ) {
+            const std::string_view l_argument = _arguments[ l_index ];
+
+            if ( l_argument == "--headless" ) {
+                _applicationState.isHeadless = true;
+
+                continue;
+            }
+
+            // Every other option takes a value
+            if ( ( l_index + 1 ) >= _arguments.size() ) {
+                goto EXIT;
+            }
+
+            const std::string_view l_value = _arguments[ ++l_index ];
+
+            if ( l_argument == "--record" ) {
+                _replayMode = replay::mode_t::record;
+                _replayPath = l_value;
+
+            } else if ( l_argument == "--replay" ) {
+                _replayMode = replay::mode_t::replay;
+                _replayPath = l_value;
+
+            } else if ( l_argument == "--vsync" ) {
+                vsync::vsync_t& l_vsync =
+                    _applicationState.settings.window.vsync;
+
+                if ( l_value == "off" ) {
+                    l_vsync = vsync::vsync_t::off;
+
+                } else if ( l_value == "deadline" ) {
+                    l_vsync = vsync::vsync_t::deadline;
+
+                } else if ( l_value == "lowLatency" ) {
+                    l_vsync = vsync::vsync_t::lowLatency;
+
+                } else {
+                    goto EXIT;
+                }
+
+            } else if ( l_argument == "--report" ) {
+                _reportPath = l_value;
+
+            } else if ( l_argument == "--frames" ) {
+                const auto [ l_end, l_error ] = std::from_chars(
+                    l_value.data(), ( l_value.data() + l_value.size() ),
+                    _applicationState.frameLimit );
+
+                if ( ( l_error != std::errc() ) ||
+                     ( l_end != ( l_value.data() + l_value.size() ) ) ) {
+                    goto EXIT;
+                }
+
+            } else {
+                goto EXIT;
+            }
+        }
+
+        // Report is what headless runs are for
+        if ( !_reportPath.empty() && !_applicationState.isHeadless ) {
+            goto EXIT;
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
 static void printSupportedRenderers() {
     using rendererType_t = std::underlying_type_t< bgfx::RendererType::Enum >;
 
@@ -22,52 +121,222 @@ static void printSupportedRenderers() {
     for ( rendererType_t _index :
           std::views::iota( static_cast< rendererType_t >( 0 ),
                             l_supportedRenderersAmount ) ) {
-        log::debug( std::format(
+        log::debug(
             " - {}",
-            bgfx::getRendererName( l_supportedRenderers.at( _index ) ) ) );
+            bgfx::getRendererName( l_supportedRenderers.at( _index ) ) );
     }
 }
 
-auto main() -> int {
-    runtime::applicationState_t l_applicationState;
-
-    printSupportedRenderers();
-
+// Events, simulation and every renderer API call
+static void game( runtime::applicationState_t& _applicationState ) {
     {
-        if ( !runtime::init( l_applicationState ) ) {
+        if ( !runtime::init( _applicationState ) ) {
             goto EXIT;
         }
 
+        const bool l_isReplaying =
+            ( replay::mode() == replay::mode_t::replay );
+        const bool l_isHeadless = _applicationState.isHeadless;
+
         for ( ;; ) {
-            vsync::begin();
+            PROFILE_SCOPE( "frame" );
 
-            SDL_PumpEvents();
+            if ( _applicationState.frameLimit &&
+                 ( _applicationState.totalFramesRendered >=
+                   _applicationState.frameLimit ) ) {
+                _applicationState.status = true;
 
-            runtime::event_t l_event{};
+                break;
+            }
 
-            while ( SDL_PollEvent( &l_event ) ) {
-                if ( !runtime::event( l_applicationState, l_event ) ) {
-                    goto EXIT;
+            // Waiting on events paces hidden frames instead of vsync
+            const bool l_isHidden =
+                ( governor::mode() == governor::mode_t::hidden );
+
+            // Headless runs as fast as it can, so frame time is CPU time
+            const bool l_isPaced = ( !l_isHidden && !l_isHeadless );
+
+            // Low latency mode sleeps here, right before input is read
+            if ( l_isPaced ) {
+                PROFILE_SCOPE( "vsync::begin" );
+
+                vsync::begin();
+            }
+
+            {
+                PROFILE_SCOPE( "events" );
+                const report::scope_t l_reportScope{ report::phase_t::events };
+
+                // Without video there is nothing to pump
+                if ( !l_isHeadless ) {
+                    SDL_PumpEvents();
+                }
+
+                runtime::event_t l_event{};
+
+                if ( l_isReplaying ) {
+                    // Window is still serviced, only quitting is honoured
+                    while ( !l_isHeadless && SDL_PollEvent( &l_event ) ) {
+                        if ( ( l_event.type == SDL_EVENT_QUIT ) &&
+                             !runtime::event( _applicationState, l_event ) ) {
+                            goto EXIT;
+                        }
+                    }
+
+                    if ( !replay::read( _applicationState.replayFrame ) ) {
+                        log::info( "Replay finished" );
+
+                        _applicationState.status = true;
+
+                        break;
+                    }
+
+                    for ( const replay::event_t& l_recorded :
+                          _applicationState.replayFrame.events ) {
+                        if ( !runtime::event( _applicationState,
+                                              replay::toSDL( l_recorded ) ) ) {
+                            goto EXIT;
+                        }
+                    }
+
+                } else if ( l_isHidden &&
+                     SDL_WaitEventTimeout(
+                         &l_event, governor::g_hiddenWaitMilliseconds ) ) {
+                    if ( !runtime::event( _applicationState, l_event ) ) {
+                        goto EXIT;
+                    }
+                }
+
+                if ( !l_isReplaying && !l_isHeadless ) {
+                    while ( SDL_PollEvent( &l_event ) ) {
+                        if ( !runtime::event( _applicationState, l_event ) ) {
+                            goto EXIT;
+                        }
+                    }
+                }
+
+                // NULL means last event on current frame
+                if ( !runtime::event( _applicationState, {} ) ) {
+                    break;
                 }
             }
 
-            // NULL means last event on current frame
-            if ( !runtime::event( l_applicationState, {} ) ) {
+            if ( !runtime::iterate( _applicationState ) ) {
                 break;
             }
 
-            if ( !runtime::iterate( l_applicationState ) ) {
-                break;
+            if ( l_isPaced ) {
+                PROFILE_SCOPE( "vsync::end" );
+
+                vsync::end();
             }
 
-            vsync::end();
+            FPS::frame();
+            report::frame();
 
-            ( l_applicationState.totalFramesRendered )++;
+            ( _applicationState.totalFramesRendered )++;
         }
     }
 
 EXIT:
-    runtime::quit( l_applicationState );
+    // Renderer shutdown waits on render thread
+    runtime::quit( _applicationState );
+
+    _applicationState.isGameThreadRunning = false;
+}
+
+auto main( int _argumentCount, char** _argumentVector ) -> int {
+    log::addSink( log::console() );
+    // Last output of a crashed run ends up on stderr
+    log::addSink( log::ring() );
+
+    log::init();
+
+    runtime::applicationState_t l_applicationState;
+    std::string_view l_reportPath;
+
+    {
+        replay::mode_t l_replayMode = replay::mode_t::off;
+        std::string_view l_replayPath;
+
+        if ( !parseArguments(
+                 std::span< char* >( _argumentVector, _argumentCount ),
+                 l_applicationState, l_replayMode, l_replayPath,
+                 l_reportPath ) ) {
+            log::error( g_usage );
+
+            log::quit();
+
+            return ( EXIT_FAILURE );
+        }
+
+        if ( !replay::init( l_replayMode, l_replayPath ) ) {
+            log::quit();
+
+            return ( EXIT_FAILURE );
+        }
+
+        if ( l_applicationState.isHeadless ) {
+            // Recording decides its own length
+            if ( !l_applicationState.frameLimit &&
+                 ( l_replayMode != replay::mode_t::replay ) ) {
+                l_applicationState.frameLimit = g_headlessFrameLimit;
+            }
+
+            if ( l_reportPath.empty() ) {
+                l_reportPath = "report.json";
+            }
+
+            report::init( l_applicationState.frameLimit );
+        }
+    }
+
+    printSupportedRenderers();
+
+    // Before bgfx::init, so this thread becomes render thread and bgfx::frame
+    // on game thread only hands frames over
+    bgfx::renderFrame();
+
+    {
+        l_applicationState.isGameThreadRunning = true;
+
+        std::jthread l_gameThread( game, std::ref( l_applicationState ) );
+
+        while ( l_applicationState.isGameThreadRunning ) {
+            switch ( bgfx::renderFrame( g_renderFrameTimeout ) ) {
+                case bgfx::RenderFrame::Render: {
+                    ( l_applicationState.framesPresented )++;
+
+                    break;
+                }
+
+                // Renderer not initialized yet or already shut down
+                case bgfx::RenderFrame::NoContext: {
+                    std::this_thread::yield();
+
+                    break;
+                }
+
+                default: {
+                }
+            }
+        }
+    }
+
+    if ( l_applicationState.isHeadless ) {
+        // Regression gate, a run without report fails
+        if ( !report::write( l_reportPath ) ) {
+            l_applicationState.status = false;
+        }
+
+        report::quit();
+    }
+
+    // Writes what recording still buffers
+    replay::quit();
+
+    // Last, every other thread has stopped logging
+    log::quit();
 
     return ( ( l_applicationState.status ) ? ( EXIT_SUCCESS )
                                            : ( EXIT_FAILURE ) );
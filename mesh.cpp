@@ -0,0 +1,198 @@
+#include "mesh.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "log.hpp"
+
+namespace mesh {
+
+namespace {
+
+const auto g_pageSize = static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+
+auto validate( const file_t& _file ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        if ( _file.size < sizeof( header_t ) ) {
+            log::error( "File is smaller than header" );
+
+            goto EXIT;
+        }
+
+        const header_t& l_header = _file.header();
+
+        if ( l_header.magic != g_magic ) {
+            log::error( "Wrong magic" );
+
+            goto EXIT;
+        }
+
+        if ( l_header.version != g_version ) {
+            log::error( std::format( "Version mismatch: file {}, expected {}",
+                                     l_header.version, g_version ) );
+
+            goto EXIT;
+        }
+
+        if ( ( l_header.alignment != g_alignment ) ||
+             ( l_header.size != _file.size ) ) {
+            log::error( "Alignment or size mismatch" );
+
+            goto EXIT;
+        }
+
+        if ( ( ( l_header.recordsOffset +
+                 ( l_header.meshCount * sizeof( record_t ) ) ) > _file.size ) ||
+             ( ( l_header.texturesOffset +
+                 ( l_header.textureCount * sizeof( texture_t ) ) ) >
+               _file.size ) ) {
+            log::error( "Records are out of bounds" );
+
+            goto EXIT;
+        }
+
+        for ( const record_t& l_record : _file.records() ) {
+            const size_t l_verticesEnd =
+                ( l_record.verticesOffset +
+                  ( l_record.vertexCount * l_record.vertexStride() ) );
+            const size_t l_indicesEnd =
+                ( l_record.indicesOffset +
+                  ( l_record.indexCount * sizeof( index_t ) ) );
+
+            if ( ( l_verticesEnd > _file.size ) ||
+                 ( l_indicesEnd > _file.size ) ) {
+                log::error( "Mesh data is out of bounds" );
+
+                goto EXIT;
+            }
+
+            if ( !l_record.lodCount || ( l_record.lodCount > g_maxLodCount ) ) {
+                log::error( "Wrong level of detail count" );
+
+                goto EXIT;
+            }
+
+            for ( const lod_t& l_lod : l_record.levels() ) {
+                if ( ( static_cast< size_t >( l_lod.indexOffset ) +
+                       l_lod.indexCount ) > l_record.indexCount ) {
+                    log::error( "Level of detail is out of bounds" );
+
+                    goto EXIT;
+                }
+            }
+        }
+
+        for ( const texture_t& l_texture : _file.textures() ) {
+            if ( ( l_texture.dataOffset + l_texture.size ) > _file.size ) {
+                log::error( "Texture data is out of bounds" );
+
+                goto EXIT;
+            }
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto map( const std::string_view _path, file_t& _file ) -> bool {
+    log::variable( _path );
+
+    bool l_returnValue = false;
+
+    int l_fileDescriptor = -1;
+
+    {
+        if ( _file.data ) {
+            log::error( "Already mapped" );
+
+            goto EXIT;
+        }
+
+        l_fileDescriptor = open( std::string( _path ).c_str(), O_RDONLY );
+
+        if ( l_fileDescriptor == -1 ) {
+            log::error( std::format( "Opening '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        struct stat l_stat{};
+
+        if ( fstat( l_fileDescriptor, &l_stat ) == -1 ) {
+            log::error( std::format( "Querying size of '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        void* l_data = mmap( nullptr, l_stat.st_size, PROT_READ, MAP_PRIVATE,
+                             l_fileDescriptor, 0 );
+
+        if ( l_data == MAP_FAILED ) {
+            log::error( std::format( "Mapping '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        // Renderer reads whole buffers right after creation
+        madvise( l_data, l_stat.st_size, MADV_WILLNEED );
+
+        _file.data = static_cast< const std::byte* >( l_data );
+        _file.size = l_stat.st_size;
+
+        if ( !validate( _file ) ) {
+            log::error( std::format( "Validating '{}'", _path ) );
+
+            unmap( _file );
+
+            goto EXIT;
+        }
+
+        log::info( "Mapped '{}': {} meshes, {} bytes", _path,
+                   _file.header().meshCount, _file.size );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    if ( l_fileDescriptor != -1 ) {
+        close( l_fileDescriptor );
+    }
+
+    return ( l_returnValue );
+}
+
+void prefault( const file_t& _file, const record_t& _record ) {
+    auto l_touch = [ & ]( std::span< const std::byte > _range ) {
+        const volatile std::byte* l_data = _range.data();
+
+        for ( size_t l_offset = 0; l_offset < _range.size();
+              l_offset += g_pageSize ) {
+            ( void )l_data[ l_offset ];
+        }
+    };
+
+    l_touch( _file.vertices( _record ) );
+    l_touch( std::as_bytes( _file.indices( _record ) ) );
+}
+
+void unmap( file_t& _file ) {
+    if ( _file.data ) {
+        munmap( const_cast< std::byte* >( _file.data ), _file.size );
+    }
+
+    _file.data = nullptr;
+    _file.size = 0;
+}
+
+} // namespace mesh
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Cooked mesh format
+//
+// [ header_t ][ record_t * meshCount ][ texture_t * textureCount ]
+// [ vertices | indices ... ][ texture data ... ]
+//
+// Indices of every level of detail follow each other, levels share vertices
+//
+// Every block starts at a multiple of g_alignment, so the runtime can hand
+// ranges of the mapped file straight to the renderer
+namespace mesh {
+
+// "AMSH"
+inline constexpr const uint32_t g_magic = 0x48534D41;
+inline constexpr const uint32_t g_version = 4;
+inline constexpr const size_t g_alignment = 16;
+inline constexpr const size_t g_textureNameLength = 128;
+inline constexpr const size_t g_textureHintLength = 8;
+inline constexpr const size_t g_maxLodCount = 4;
+
+// Record flags
+inline constexpr const uint32_t g_flagQuantized = 0b1;
+
+using vertex_t = struct vertex {
+    float x, y, z;
+    float nx, ny, nz;
+    float u, v;
+};
+
+// Normalized positions scaled and biased per mesh, octahedral normal and half
+// texture coordinates
+using quantizedVertex_t = struct quantizedVertex {
+    int16_t x, y, z, w;
+    int16_t nx, ny;
+    uint16_t u, v;
+};
+
+static_assert( sizeof( quantizedVertex_t ) == ( sizeof( vertex_t ) / 2 ) );
+
+using index_t = uint32_t;
+
+// Range of record indices drawn at one level of detail
+using lod_t = struct lod {
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    // Upper bound of surface deviation from level 0, in mesh units
+    float error = 0;
+    uint32_t reserved = 0;
+};
+
+using header_t = struct header {
+    uint32_t magic = g_magic;
+    uint32_t version = g_version;
+    uint32_t meshCount = 0;
+    uint32_t textureCount = 0;
+    uint32_t alignment = g_alignment;
+    uint32_t reserved = 0;
+    // Whole file size, used to validate truncated files
+    uint64_t size = 0;
+    uint64_t recordsOffset = 0;
+    uint64_t texturesOffset = 0;
+};
+
+using record_t = struct record {
+    uint64_t verticesOffset = 0;
+    uint64_t indicesOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t flags = 0;
+    uint32_t lodCount = 0;
+    // Bounding sphere, center and radius
+    std::array< float, 4 > bounds{};
+    // position = ( quantized * scale ) + bias, if quantized
+    std::array< float, 4 > positionScale = { 1, 1, 1, 0 };
+    std::array< float, 4 > positionBias{};
+    // Diffuse texture path or "*N" for embedded texture, empty if none
+    std::array< char, g_textureNameLength > texture{};
+    // Finest first
+    std::array< lod_t, g_maxLodCount > lods{};
+
+    [[nodiscard]] auto levels() const -> std::span< const lod_t > {
+        return ( std::span( lods ).first( lodCount ) );
+    }
+
+    [[nodiscard]] auto isQuantized() const -> bool {
+        return ( ( flags & g_flagQuantized ) != 0 );
+    }
+
+    [[nodiscard]] auto vertexStride() const -> size_t {
+        return ( ( isQuantized() ) ? ( sizeof( quantizedVertex_t ) )
+                                   : ( sizeof( vertex_t ) ) );
+    }
+};
+
+// Embedded texture, referenced by meshes as "*N"
+using texture_t = struct texture {
+    uint64_t dataOffset = 0;
+    uint64_t size = 0;
+    // Raw RGBA8 if set, otherwise data is an encoded image
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Encoded image format, e.g. "png"
+    std::array< char, g_textureHintLength > hint{};
+};
+
+static_assert( ( sizeof( header_t ) % g_alignment ) == 0 );
+static_assert( ( sizeof( record_t ) % g_alignment ) == 0 );
+static_assert( ( sizeof( texture_t ) % g_alignment ) == 0 );
+static_assert( ( sizeof( lod_t ) % g_alignment ) == 0 );
+
+inline constexpr auto align( const size_t _offset ) -> size_t {
+    return ( ( _offset + ( g_alignment - 1 ) ) & ~( g_alignment - 1 ) );
+}
+
+// Read-only mapping of a cooked mesh file
+using file_t = struct file {
+    file() = default;
+    file( const file& ) = delete;
+    file( file&& ) = delete;
+    ~file() = default;
+    auto operator=( const file& ) -> file& = delete;
+    auto operator=( file&& ) -> file& = delete;
+
+    [[nodiscard]] auto header() const -> const header_t& {
+        return ( *reinterpret_cast< const header_t* >( data ) );
+    }
+
+    [[nodiscard]] auto records() const -> std::span< const record_t > {
+        return ( std::span( reinterpret_cast< const record_t* >(
+                                data + header().recordsOffset ),
+                            header().meshCount ) );
+    }
+
+    // Layout depends on record flags
+    [[nodiscard]] auto vertices( const record_t& _record ) const
+        -> std::span< const std::byte > {
+        return ( std::span(
+            ( data + _record.verticesOffset ),
+            ( _record.vertexCount * _record.vertexStride() ) ) );
+    }
+
+    [[nodiscard]] auto indices( const record_t& _record ) const
+        -> std::span< const index_t > {
+        return ( std::span( reinterpret_cast< const index_t* >(
+                                data + _record.indicesOffset ),
+                            _record.indexCount ) );
+    }
+
+    [[nodiscard]] auto textures() const -> std::span< const texture_t > {
+        return ( std::span( reinterpret_cast< const texture_t* >(
+                                data + header().texturesOffset ),
+                            header().textureCount ) );
+    }
+
+    [[nodiscard]] auto textureData( const texture_t& _texture ) const
+        -> std::span< const std::byte > {
+        return ( std::span( ( data + _texture.dataOffset ), _texture.size ) );
+    }
+
+    const std::byte* data = nullptr;
+    size_t size = 0;
+};
+
+auto map( const std::string_view _path, file_t& _file ) -> bool;
+void unmap( file_t& _file );
+
+// Touches every page of mesh data, so renderer does not fault on them
+void prefault( const file_t& _file, const record_t& _record );
+
+} // namespace mesh
@@ -0,0 +1,415 @@
+#include "optimize.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <ranges>
+
+namespace optimize {
+
+namespace {
+
+// Forsyth scoring parameters
+inline constexpr const size_t g_scoringCacheSize = 32;
+inline constexpr const float g_cacheDecayPower = 1.5F;
+inline constexpr const float g_lastTriangleScore = 0.75F;
+inline constexpr const float g_valenceBoostScale = 2.0F;
+inline constexpr const float g_valenceBoostPower = 0.5F;
+
+inline constexpr const uint32_t g_none = std::numeric_limits< uint32_t >::max();
+
+auto vertexScore( const int _cachePosition, const uint32_t _remaining )
+    -> float {
+    float l_returnValue = -1.0F;
+
+    // No triangles left to use it
+    if ( _remaining ) {
+        l_returnValue = 0.0F;
+
+        if ( _cachePosition >= 0 ) {
+            if ( _cachePosition < 3 ) {
+                // Just used by last triangle, fixed score prevents reusing the
+                // same edge over and over
+                l_returnValue = g_lastTriangleScore;
+
+            } else {
+                const float l_scale =
+                    ( 1.0F / static_cast< float >( g_scoringCacheSize - 3 ) );
+
+                l_returnValue = std::pow(
+                    ( 1.0F - ( static_cast< float >( _cachePosition - 3 ) *
+                               l_scale ) ),
+                    g_cacheDecayPower );
+            }
+        }
+
+        // Favour vertices with few triangles left, so they get off the table
+        l_returnValue +=
+            ( g_valenceBoostScale *
+              std::pow( static_cast< float >( _remaining ),
+                        -g_valenceBoostPower ) );
+    }
+
+    return ( l_returnValue );
+}
+
+// Simulated FIFO cache via insertion timestamps
+// Calls _miss for every vertex transformed
+template < typename F >
+void simulate( std::span< const mesh::index_t > _indices,
+               size_t _vertexCount,
+               F&& _miss ) {
+    std::vector< size_t > l_timestamps( _vertexCount, 0 );
+    size_t l_time = ( g_cacheSize + 1 );
+
+    for ( const auto [ l_position, l_index ] :
+          _indices | std::views::enumerate ) {
+        if ( ( l_time - l_timestamps[ l_index ] ) > g_cacheSize ) {
+            l_timestamps[ l_index ] = l_time;
+            l_time++;
+
+            _miss( static_cast< size_t >( l_position / 3 ) );
+        }
+    }
+}
+
+} // namespace
+
+auto analyze( std::span< const mesh::index_t > _indices, size_t _vertexCount )
+    -> statistics_t {
+    statistics_t l_returnValue;
+
+    size_t l_misses = 0;
+
+    simulate( _indices, _vertexCount, [ & ]( size_t ) { l_misses++; } );
+
+    if ( !_indices.empty() && _vertexCount ) {
+        l_returnValue.acmr = ( static_cast< float >( l_misses ) /
+                               static_cast< float >( _indices.size() / 3 ) );
+        l_returnValue.atvr = ( static_cast< float >( l_misses ) /
+                               static_cast< float >( _vertexCount ) );
+    }
+
+    return ( l_returnValue );
+}
+
+void vertexCache( std::vector< mesh::index_t >& _indices,
+                  size_t _vertexCount ) {
+    const size_t l_triangleCount = ( _indices.size() / 3 );
+
+    if ( !l_triangleCount ) {
+        return;
+    }
+
+    // Vertex to triangles adjacency
+    std::vector< uint32_t > l_remaining( _vertexCount, 0 );
+    std::vector< uint32_t > l_offsets( _vertexCount + 1, 0 );
+    std::vector< uint32_t > l_adjacency( _indices.size() );
+
+    {
+        for ( const mesh::index_t l_index : _indices ) {
+            l_remaining[ l_index ]++;
+        }
+
+        std::exclusive_scan( l_remaining.begin(), l_remaining.end(),
+                             l_offsets.begin(), 0U );
+
+        l_offsets.back() = _indices.size();
+
+        std::vector< uint32_t > l_fill( l_offsets.begin(),
+                                        ( l_offsets.end() - 1 ) );
+
+        for ( size_t l_position = 0; l_position < _indices.size();
+              l_position++ ) {
+            l_adjacency[ l_fill[ _indices[ l_position ] ]++ ] =
+                ( l_position / 3 );
+        }
+    }
+
+    std::vector< float > l_vertexScores( _vertexCount );
+    std::vector< float > l_triangleScores( l_triangleCount, 0.0F );
+    std::vector< bool > l_isTriangleAdded( l_triangleCount, false );
+
+    for ( size_t l_vertex = 0; l_vertex < _vertexCount; l_vertex++ ) {
+        l_vertexScores[ l_vertex ] = vertexScore( -1, l_remaining[ l_vertex ] );
+    }
+
+    for ( size_t l_position = 0; l_position < _indices.size(); l_position++ ) {
+        l_triangleScores[ l_position / 3 ] +=
+            l_vertexScores[ _indices[ l_position ] ];
+    }
+
+    std::vector< mesh::index_t > l_output;
+
+    l_output.reserve( _indices.size() );
+
+    std::vector< uint32_t > l_cache;
+    std::vector< uint32_t > l_newCache;
+
+    l_cache.reserve( g_scoringCacheSize + 3 );
+    l_newCache.reserve( g_scoringCacheSize + 3 );
+
+    uint32_t l_bestTriangle = static_cast< uint32_t >(
+        std::ranges::max_element( l_triangleScores ) -
+        l_triangleScores.begin() );
+    size_t l_cursor = 0;
+
+    for ( size_t l_added = 0; l_added < l_triangleCount; l_added++ ) {
+        // Nothing adjacent to cache, continue in input order
+        if ( l_bestTriangle == g_none ) {
+            while ( l_isTriangleAdded[ l_cursor ] ) {
+                l_cursor++;
+            }
+
+            l_bestTriangle = l_cursor;
+        }
+
+        const auto l_triangle =
+            std::span( _indices ).subspan( ( l_bestTriangle * 3 ), 3 );
+
+        l_isTriangleAdded[ l_bestTriangle ] = true;
+        l_output.insert( l_output.end(), l_triangle.begin(),
+                         l_triangle.end() );
+
+        // Drop triangle from adjacency of its vertices
+        for ( const mesh::index_t l_vertex : l_triangle ) {
+            const auto l_begin =
+                ( l_adjacency.begin() + l_offsets[ l_vertex ] );
+            const auto l_end = ( l_begin + l_remaining[ l_vertex ] );
+
+            std::iter_swap( std::find( l_begin, l_end, l_bestTriangle ),
+                            ( l_end - 1 ) );
+
+            l_remaining[ l_vertex ]--;
+        }
+
+        // Triangle vertices go to the front of LRU cache
+        l_newCache.assign( l_triangle.begin(), l_triangle.end() );
+
+        for ( const uint32_t l_vertex : l_cache ) {
+            if ( std::ranges::find( l_triangle, l_vertex ) ==
+                 l_triangle.end() ) {
+                l_newCache.push_back( l_vertex );
+            }
+        }
+
+        // Evicted
+        for ( size_t l_position = g_scoringCacheSize;
+              l_position < l_newCache.size(); l_position++ ) {
+            const uint32_t l_vertex = l_newCache[ l_position ];
+
+            l_vertexScores[ l_vertex ] =
+                vertexScore( -1, l_remaining[ l_vertex ] );
+        }
+
+        if ( l_newCache.size() > g_scoringCacheSize ) {
+            l_newCache.resize( g_scoringCacheSize );
+        }
+
+        std::swap( l_cache, l_newCache );
+
+        for ( const auto [ l_position, l_vertex ] :
+              l_cache | std::views::enumerate ) {
+            l_vertexScores[ l_vertex ] =
+                vertexScore( l_position, l_remaining[ l_vertex ] );
+        }
+
+        // Only triangles touching cache changed score
+        l_bestTriangle = g_none;
+
+        float l_bestScore = -1.0F;
+
+        for ( const uint32_t l_vertex : l_cache ) {
+            const auto l_begin =
+                ( l_adjacency.begin() + l_offsets[ l_vertex ] );
+            const auto l_end = ( l_begin + l_remaining[ l_vertex ] );
+
+            for ( const uint32_t l_adjacent : std::ranges::subrange(
+                      l_begin, l_end ) ) {
+                float& l_score = l_triangleScores[ l_adjacent ];
+
+                l_score = 0.0F;
+
+                for ( size_t l_corner = 0; l_corner < 3; l_corner++ ) {
+                    l_score += l_vertexScores[ _indices[ ( l_adjacent * 3 ) +
+                                                         l_corner ] ];
+                }
+
+                if ( l_score > l_bestScore ) {
+                    l_bestScore = l_score;
+                    l_bestTriangle = l_adjacent;
+                }
+            }
+        }
+    }
+
+    _indices = std::move( l_output );
+}
+
+void overdraw( std::vector< mesh::index_t >& _indices,
+               std::span< const mesh::vertex_t > _vertices,
+               float _threshold ) {
+    const size_t l_triangleCount = ( _indices.size() / 3 );
+
+    if ( l_triangleCount < 2 ) {
+        return;
+    }
+
+    // Cluster starts wherever cache misses a whole triangle, reordering there
+    // costs almost nothing in cache efficiency
+    std::vector< size_t > l_clusters;
+
+    {
+        std::vector< uint8_t > l_misses( l_triangleCount, 0 );
+
+        simulate( _indices, _vertices.size(),
+                  [ & ]( size_t _triangle ) { l_misses[ _triangle ]++; } );
+
+        for ( size_t l_triangle = 0; l_triangle < l_triangleCount;
+              l_triangle++ ) {
+            if ( !l_triangle || ( l_misses[ l_triangle ] == 3 ) ) {
+                l_clusters.push_back( l_triangle );
+            }
+        }
+
+        l_clusters.push_back( l_triangleCount );
+    }
+
+    const size_t l_clusterCount = ( l_clusters.size() - 1 );
+
+    if ( l_clusterCount < 2 ) {
+        return;
+    }
+
+    auto l_position = [ & ]( mesh::index_t _index ) {
+        const mesh::vertex_t& l_vertex = _vertices[ _index ];
+
+        return ( std::array< float, 3 >{ l_vertex.x, l_vertex.y, l_vertex.z } );
+    };
+
+    std::array< float, 3 > l_meshCentroid{};
+
+    for ( const mesh::vertex_t& l_vertex : _vertices ) {
+        l_meshCentroid[ 0 ] += l_vertex.x;
+        l_meshCentroid[ 1 ] += l_vertex.y;
+        l_meshCentroid[ 2 ] += l_vertex.z;
+    }
+
+    for ( float& l_axis : l_meshCentroid ) {
+        l_axis /= static_cast< float >( _vertices.size() );
+    }
+
+    // Clusters facing outwards and far from center occlude the most
+    std::vector< float > l_sortKeys( l_clusterCount );
+
+    for ( size_t l_cluster = 0; l_cluster < l_clusterCount; l_cluster++ ) {
+        std::array< float, 3 > l_centroid{};
+        std::array< float, 3 > l_normal{};
+        float l_totalArea = 0.0F;
+
+        for ( size_t l_triangle = l_clusters[ l_cluster ];
+              l_triangle < l_clusters[ l_cluster + 1 ]; l_triangle++ ) {
+            const auto l_a = l_position( _indices[ ( l_triangle * 3 ) + 0 ] );
+            const auto l_b = l_position( _indices[ ( l_triangle * 3 ) + 1 ] );
+            const auto l_c = l_position( _indices[ ( l_triangle * 3 ) + 2 ] );
+
+            std::array< float, 3 > l_edge0{};
+            std::array< float, 3 > l_edge1{};
+
+            for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+                l_edge0[ l_axis ] = ( l_b[ l_axis ] - l_a[ l_axis ] );
+                l_edge1[ l_axis ] = ( l_c[ l_axis ] - l_a[ l_axis ] );
+            }
+
+            // Area weighted
+            const std::array< float, 3 > l_cross = {
+                ( ( l_edge0[ 1 ] * l_edge1[ 2 ] ) -
+                  ( l_edge0[ 2 ] * l_edge1[ 1 ] ) ),
+                ( ( l_edge0[ 2 ] * l_edge1[ 0 ] ) -
+                  ( l_edge0[ 0 ] * l_edge1[ 2 ] ) ),
+                ( ( l_edge0[ 0 ] * l_edge1[ 1 ] ) -
+                  ( l_edge0[ 1 ] * l_edge1[ 0 ] ) ),
+            };
+
+            const float l_area = std::sqrt(
+                ( l_cross[ 0 ] * l_cross[ 0 ] ) +
+                ( l_cross[ 1 ] * l_cross[ 1 ] ) +
+                ( l_cross[ 2 ] * l_cross[ 2 ] ) );
+
+            l_totalArea += l_area;
+
+            for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+                l_normal[ l_axis ] += l_cross[ l_axis ];
+                l_centroid[ l_axis ] +=
+                    ( ( l_a[ l_axis ] + l_b[ l_axis ] + l_c[ l_axis ] ) *
+                      l_area );
+            }
+        }
+
+        const float l_normalLength =
+            std::sqrt( ( l_normal[ 0 ] * l_normal[ 0 ] ) +
+                       ( l_normal[ 1 ] * l_normal[ 1 ] ) +
+                       ( l_normal[ 2 ] * l_normal[ 2 ] ) );
+        float l_key = 0.0F;
+
+        if ( ( l_normalLength > 0.0F ) && ( l_totalArea > 0.0F ) ) {
+            for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+                const float l_clusterCentroid =
+                    ( l_centroid[ l_axis ] / ( l_totalArea * 3.0F ) );
+
+                l_key += ( ( l_clusterCentroid - l_meshCentroid[ l_axis ] ) *
+                           ( l_normal[ l_axis ] / l_normalLength ) );
+            }
+        }
+
+        l_sortKeys[ l_cluster ] = l_key;
+    }
+
+    std::vector< size_t > l_order( l_clusterCount );
+
+    std::iota( l_order.begin(), l_order.end(), 0 );
+
+    std::ranges::stable_sort( l_order, [ & ]( size_t _lhs, size_t _rhs ) {
+        return ( l_sortKeys[ _lhs ] > l_sortKeys[ _rhs ] );
+    } );
+
+    std::vector< mesh::index_t > l_output;
+
+    l_output.reserve( _indices.size() );
+
+    for ( const size_t l_cluster : l_order ) {
+        l_output.insert( l_output.end(),
+                         ( _indices.begin() + ( l_clusters[ l_cluster ] * 3 ) ),
+                         ( _indices.begin() +
+                           ( l_clusters[ l_cluster + 1 ] * 3 ) ) );
+    }
+
+    if ( analyze( l_output, _vertices.size() ).acmr <=
+         ( analyze( _indices, _vertices.size() ).acmr * _threshold ) ) {
+        _indices = std::move( l_output );
+    }
+}
+
+void vertexFetch( std::vector< mesh::vertex_t >& _vertices,
+                  std::vector< mesh::index_t >& _indices ) {
+    std::vector< mesh::index_t > l_remap( _vertices.size(), g_none );
+    std::vector< mesh::vertex_t > l_output;
+
+    l_output.reserve( _vertices.size() );
+
+    for ( mesh::index_t& l_index : _indices ) {
+        if ( l_remap[ l_index ] == g_none ) {
+            l_remap[ l_index ] = l_output.size();
+
+            l_output.push_back( _vertices[ l_index ] );
+        }
+
+        l_index = l_remap[ l_index ];
+    }
+
+    _vertices = std::move( l_output );
+}
+
+} // namespace optimize
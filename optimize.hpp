@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "mesh.hpp"
+
+// Offline index and vertex reordering
+namespace optimize {
+
+// Simulated post-transform FIFO cache size
+inline constexpr const size_t g_cacheSize = 16;
+
+using statistics_t = struct statistics {
+    statistics() = default;
+    statistics( const statistics& ) = default;
+    statistics( statistics&& ) = default;
+    ~statistics() = default;
+    auto operator=( const statistics& ) -> statistics& = default;
+    auto operator=( statistics&& ) -> statistics& = default;
+
+    // Average cache miss ratio, transformed vertices per triangle
+    float acmr = 0;
+    // Average transformed to vertex ratio, 1 is ideal
+    float atvr = 0;
+};
+
+auto analyze( std::span< const mesh::index_t > _indices, size_t _vertexCount )
+    -> statistics_t;
+
+// Forsyth linear-speed vertex cache optimization
+void vertexCache( std::vector< mesh::index_t >& _indices,
+                  size_t _vertexCount );
+
+// Reorders clusters of cache optimized triangles front to back
+// Keeps ACMR within _threshold of the input
+void overdraw( std::vector< mesh::index_t >& _indices,
+               std::span< const mesh::vertex_t > _vertices,
+               float _threshold = 1.05F );
+
+// Renumbers vertices in first use order, drops unused ones
+void vertexFetch( std::vector< mesh::vertex_t >& _vertices,
+                  std::vector< mesh::index_t >& _indices );
+
+} // namespace optimize
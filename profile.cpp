@@ -0,0 +1,281 @@
+#include "profile.hpp"
+
+#if defined( PROFILE )
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <string>
+
+#include "log.hpp"
+
+namespace profile {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+using event_t = struct event {
+    event() = default;
+    event( const event& ) = default;
+    event( event&& ) = default;
+    ~event() = default;
+    auto operator=( const event& ) -> event& = default;
+    auto operator=( event&& ) -> event& = default;
+
+    const char* name = nullptr;
+    int64_t start = 0;
+    int64_t duration = 0;
+};
+
+// Written by owning thread only, count publishes finished events
+using buffer_t = struct buffer {
+    buffer() = default;
+    buffer( const buffer& ) = delete;
+    buffer( buffer&& ) = delete;
+    ~buffer() = default;
+    auto operator=( const buffer& ) -> buffer& = delete;
+    auto operator=( buffer&& ) -> buffer& = delete;
+
+    std::array< event_t, g_eventsPerThread > events;
+    alignas( g_cacheLineSize ) std::atomic< size_t > count = 0;
+    std::atomic< size_t > dropped = 0;
+};
+
+const clock::time_point g_epoch = clock::now();
+
+// Buffers live until exit, so dump never races their release
+std::array< std::atomic< buffer_t* >, g_maxThreads > g_buffers{};
+std::atomic< size_t > g_bufferCount = 0;
+
+thread_local buffer_t* g_buffer = nullptr;
+// Thread registered too late, records nothing
+thread_local bool g_isUnregistered = false;
+
+auto now() -> int64_t {
+    return ( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                 clock::now() - g_epoch )
+                 .count() );
+}
+
+auto threadBuffer() -> buffer_t* {
+    if ( !g_buffer && !g_isUnregistered ) {
+        const size_t l_index =
+            g_bufferCount.fetch_add( 1, std::memory_order_relaxed );
+
+        if ( l_index < g_maxThreads ) {
+            g_buffer = new buffer_t;
+
+            g_buffers[ l_index ].store( g_buffer, std::memory_order_release );
+
+        } else {
+            g_isUnregistered = true;
+        }
+    }
+
+    return ( g_buffer );
+}
+
+} // namespace
+
+scope::scope( name_t _name ) : _scopeName( _name ), _start( now() ) {}
+
+scope::~scope() {
+    const int64_t l_end = now();
+
+    buffer_t* l_buffer = threadBuffer();
+
+    if ( !l_buffer ) {
+        return;
+    }
+
+    const size_t l_count = l_buffer->count.load( std::memory_order_relaxed );
+
+    if ( l_count >= g_eventsPerThread ) {
+        l_buffer->dropped.fetch_add( 1, std::memory_order_relaxed );
+
+        return;
+    }
+
+    event_t& l_event = l_buffer->events[ l_count ];
+
+    l_event.name = _scopeName.value;
+    l_event.start = _start;
+    l_event.duration = ( l_end - _start );
+
+    l_buffer->count.store( ( l_count + 1 ), std::memory_order_release );
+}
+
+auto dump( std::string_view _path ) -> bool {
+    log::variable( _path );
+
+    bool l_returnValue = false;
+
+    {
+        std::ofstream l_outputFileStream{ std::string( _path ) };
+
+        size_t l_eventCount = 0;
+        size_t l_droppedCount = 0;
+
+        l_outputFileStream << "{\"traceEvents\":[";
+
+        const size_t l_bufferCount = std::min(
+            g_bufferCount.load( std::memory_order_relaxed ), g_maxThreads );
+
+        for ( size_t l_thread = 0; l_thread < l_bufferCount; l_thread++ ) {
+            const buffer_t* l_buffer =
+                g_buffers[ l_thread ].load( std::memory_order_acquire );
+
+            // Claimed, not yet stored
+            if ( !l_buffer ) {
+                continue;
+            }
+
+            const size_t l_count =
+                l_buffer->count.load( std::memory_order_acquire );
+
+            for ( size_t l_index = 0; l_index < l_count; l_index++ ) {
+                const event_t& l_event = l_buffer->events[ l_index ];
+
+                // Chrome trace times are microseconds
+                l_outputFileStream << std::format(
+                    "{}{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+                    "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                    ( ( l_eventCount ) ? ( "," ) : ( "" ) ), l_event.name,
+                    ( static_cast< double >( l_event.start ) / 1000.0 ),
+                    ( static_cast< double >( l_event.duration ) / 1000.0 ),
+                    l_thread );
+
+                l_eventCount++;
+            }
+
+            l_droppedCount +=
+                l_buffer->dropped.load( std::memory_order_relaxed );
+        }
+
+        l_outputFileStream << "],\"displayTimeUnit\":\"ms\"}\n";
+
+        if ( !l_outputFileStream.good() ) {
+            log::error( std::format( "Writing '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        log::info( "Wrote {} profile events of {} threads to '{}', dropped {}",
+                   l_eventCount, l_bufferCount, _path, l_droppedCount );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace profile
+
+#endif
+
+#if defined( COUNT_ALLOCATIONS )
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace profile {
+
+namespace {
+
+// Not per thread, registering a thread allocates itself
+std::atomic< size_t > g_allocationCount = 0;
+std::atomic< size_t > g_allocationBytes = 0;
+
+auto allocate( size_t _size, size_t _alignment ) -> void* {
+    g_allocationCount.fetch_add( 1, std::memory_order_relaxed );
+    g_allocationBytes.fetch_add( _size, std::memory_order_relaxed );
+
+    // Zero sized allocations still need distinct addresses
+    const size_t l_size = std::max( _size, 1UZ );
+
+    void* l_returnValue =
+        ( ( _alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+              ? std::aligned_alloc(
+                    _alignment,
+                    ( ( ( l_size + _alignment - 1 ) / _alignment ) *
+                      _alignment ) )
+              : std::malloc( l_size ) );
+
+    // Nothing to throw without exceptions
+    if ( !l_returnValue ) {
+        std::abort();
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto allocations() -> allocations_t {
+    allocations_t l_returnValue;
+
+    l_returnValue.count = g_allocationCount.load( std::memory_order_relaxed );
+    l_returnValue.bytes = g_allocationBytes.load( std::memory_order_relaxed );
+
+    return ( l_returnValue );
+}
+
+} // namespace profile
+
+// Replaces global allocation functions to count them
+auto operator new( size_t _size ) -> void* {
+    return ( profile::allocate( _size, 0 ) );
+}
+
+auto operator new[]( size_t _size ) -> void* {
+    return ( profile::allocate( _size, 0 ) );
+}
+
+auto operator new( size_t _size, std::align_val_t _alignment ) -> void* {
+    return ( profile::allocate( _size, static_cast< size_t >( _alignment ) ) );
+}
+
+auto operator new[]( size_t _size, std::align_val_t _alignment ) -> void* {
+    return ( profile::allocate( _size, static_cast< size_t >( _alignment ) ) );
+}
+
+void operator delete( void* _pointer ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete[]( void* _pointer ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete( void* _pointer, size_t ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete[]( void* _pointer, size_t ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete( void* _pointer, std::align_val_t ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete[]( void* _pointer, std::align_val_t ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete( void* _pointer, size_t, std::align_val_t ) noexcept {
+    std::free( _pointer );
+}
+
+void operator delete[]( void* _pointer, size_t, std::align_val_t ) noexcept {
+    std::free( _pointer );
+}
+
+#endif
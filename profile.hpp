@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "common.hpp"
+
+// Scoped hot path instrumentation
+// Every thread records into its own buffer, dump writes Chrome trace JSON
+// that chrome://tracing and Perfetto open. Without PROFILE scopes compile
+// to nothing. COUNT_ALLOCATIONS counts allocations through operator new on
+// its own, as replacing the allocator taxes every allocation
+namespace profile {
+
+// Later scopes of a full thread are dropped
+inline constexpr const size_t g_eventsPerThread = 65536;
+inline constexpr const size_t g_maxThreads = 64;
+
+using allocations_t = struct allocations {
+    allocations() = default;
+    allocations( const allocations& ) = default;
+    allocations( allocations&& ) = default;
+    ~allocations() = default;
+    auto operator=( const allocations& ) -> allocations& = default;
+    auto operator=( allocations&& ) -> allocations& = default;
+
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+#if defined( COUNT_ALLOCATIONS )
+
+inline constexpr const bool g_isCountingAllocations = true;
+
+// Since start, on every thread
+auto allocations() -> allocations_t;
+
+#else
+
+inline constexpr const bool g_isCountingAllocations = false;
+
+inline auto allocations() -> allocations_t {
+    return {};
+}
+
+#endif
+
+#if defined( PROFILE )
+
+// Only string literals, recorded by pointer
+using name_t = struct name {
+    template < size_t N >
+    consteval name( const char ( &_name )[ N ] ) : value( _name ) {}
+    name( const name& ) = default;
+    name( name&& ) = default;
+    ~name() = default;
+    auto operator=( const name& ) -> name& = default;
+    auto operator=( name&& ) -> name& = default;
+
+    const char* value;
+};
+
+using scope_t = struct scope {
+    explicit scope( name_t _name );
+    scope( const scope& ) = delete;
+    scope( scope&& ) = delete;
+    ~scope();
+    auto operator=( const scope& ) -> scope& = delete;
+    auto operator=( scope&& ) -> scope& = delete;
+
+private:
+    name_t _scopeName;
+    int64_t _start;
+};
+
+// Everything recorded so far, safe while other threads record
+auto dump( std::string_view _path ) -> bool;
+
+#define PROFILE_SCOPE( _name ) \
+    const profile::scope_t CONCAT( l_profileScope, __LINE__ ) { _name }
+
+#else
+
+inline auto dump( std::string_view ) -> bool {
+    return ( true );
+}
+
+#define PROFILE_SCOPE( _name )
+
+#endif
+
+} // namespace profile
@@ -0,0 +1,128 @@
+#include "quantize.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace quantize {
+
+namespace {
+
+inline constexpr const float g_snorm16 =
+    std::numeric_limits< int16_t >::max();
+
+auto toSnorm16( const float _value ) -> int16_t {
+    return ( static_cast< int16_t >(
+        std::lround( std::clamp( _value, -1.0F, 1.0F ) * g_snorm16 ) ) );
+}
+
+auto toHalf( const float _value ) -> uint16_t {
+    return ( std::bit_cast< uint16_t >( static_cast< _Float16 >( _value ) ) );
+}
+
+// Unit vector onto octahedron, lower half folded over the diagonals
+auto toOctahedral( float _x, float _y, float _z ) -> std::array< float, 2 > {
+    const float l_sum = ( std::abs( _x ) + std::abs( _y ) + std::abs( _z ) );
+
+    std::array< float, 2 > l_returnValue = { 0, 0 };
+
+    if ( l_sum > 0.0F ) {
+        _x /= l_sum;
+        _y /= l_sum;
+        _z /= l_sum;
+
+        l_returnValue = { _x, _y };
+
+        if ( _z < 0.0F ) {
+            const float l_signX = ( ( _x >= 0.0F ) ? ( 1.0F ) : ( -1.0F ) );
+            const float l_signY = ( ( _y >= 0.0F ) ? ( 1.0F ) : ( -1.0F ) );
+
+            l_returnValue = { ( ( 1.0F - std::abs( _y ) ) * l_signX ),
+                              ( ( 1.0F - std::abs( _x ) ) * l_signY ) };
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto vertices( std::span< const mesh::vertex_t > _vertices,
+               std::vector< mesh::quantizedVertex_t >& _quantized,
+               std::array< float, 4 >& _positionScale,
+               std::array< float, 4 >& _positionBias ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        std::array< float, 3 > l_minimum;
+        std::array< float, 3 > l_maximum;
+
+        l_minimum.fill( std::numeric_limits< float >::max() );
+        l_maximum.fill( std::numeric_limits< float >::lowest() );
+
+        for ( const mesh::vertex_t& l_vertex : _vertices ) {
+            if ( ( std::abs( l_vertex.u ) > g_maxTextureCoordinate ) ||
+                 ( std::abs( l_vertex.v ) > g_maxTextureCoordinate ) ) {
+                goto EXIT;
+            }
+
+            const std::array< float, 3 > l_position = { l_vertex.x, l_vertex.y,
+                                                        l_vertex.z };
+
+            for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+                l_minimum[ l_axis ] =
+                    std::min( l_minimum[ l_axis ], l_position[ l_axis ] );
+                l_maximum[ l_axis ] =
+                    std::max( l_maximum[ l_axis ], l_position[ l_axis ] );
+            }
+        }
+
+        // Bounding box center to [ -1, 1 ]
+        for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+            const float l_halfExtent =
+                ( ( l_maximum[ l_axis ] - l_minimum[ l_axis ] ) * 0.5F );
+
+            _positionScale[ l_axis ] =
+                ( ( l_halfExtent > 0.0F ) ? ( l_halfExtent ) : ( 1.0F ) );
+            _positionBias[ l_axis ] =
+                ( ( l_maximum[ l_axis ] + l_minimum[ l_axis ] ) * 0.5F );
+        }
+
+        _positionScale[ 3 ] = 0.0F;
+        _positionBias[ 3 ] = 0.0F;
+
+        _quantized.clear();
+        _quantized.reserve( _vertices.size() );
+
+        for ( const mesh::vertex_t& l_vertex : _vertices ) {
+            mesh::quantizedVertex_t l_quantized{};
+
+            l_quantized.x = toSnorm16( ( l_vertex.x - _positionBias[ 0 ] ) /
+                                       _positionScale[ 0 ] );
+            l_quantized.y = toSnorm16( ( l_vertex.y - _positionBias[ 1 ] ) /
+                                       _positionScale[ 1 ] );
+            l_quantized.z = toSnorm16( ( l_vertex.z - _positionBias[ 2 ] ) /
+                                       _positionScale[ 2 ] );
+
+            const auto [ l_octahedralX, l_octahedralY ] =
+                toOctahedral( l_vertex.nx, l_vertex.ny, l_vertex.nz );
+
+            l_quantized.nx = toSnorm16( l_octahedralX );
+            l_quantized.ny = toSnorm16( l_octahedralY );
+
+            l_quantized.u = toHalf( l_vertex.u );
+            l_quantized.v = toHalf( l_vertex.v );
+
+            _quantized.push_back( l_quantized );
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace quantize
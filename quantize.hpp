@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "mesh.hpp"
+
+// Compact vertex encoding for offline cooking
+namespace quantize {
+
+// Half keeps sub-texel precision on 2048 texels wide textures up to this
+inline constexpr const float g_maxTextureCoordinate = 4.0F;
+
+// False if mesh would lose visible precision, keep full layout then
+auto vertices( std::span< const mesh::vertex_t > _vertices,
+               std::vector< mesh::quantizedVertex_t >& _quantized,
+               std::array< float, 4 >& _positionScale,
+               std::array< float, 4 >& _positionBias ) -> bool;
+
+} // namespace quantize
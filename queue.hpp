@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "common.hpp"
+
+namespace queue {
+
+// Bounded lock-free multi-producer multi-consumer queue
+// Every cell carries a sequence number, producers and consumers only contend
+// on their own cursor
+template < typename T, size_t Capacity >
+    requires( ( Capacity > 1 ) && ( ( Capacity & ( Capacity - 1 ) ) == 0 ) )
+struct mpmc {
+    mpmc() {
+        for ( size_t l_index = 0; l_index < Capacity; l_index++ ) {
+            _cells[ l_index ].sequence.store( l_index,
+                                              std::memory_order_relaxed );
+        }
+    }
+    mpmc( const mpmc& ) = delete;
+    mpmc( mpmc&& ) = delete;
+    ~mpmc() = default;
+    auto operator=( const mpmc& ) -> mpmc& = delete;
+    auto operator=( mpmc&& ) -> mpmc& = delete;
+
+    // False if full
+    auto push( T _value ) -> bool {
+        bool l_returnValue = false;
+
+        {
+            size_t l_position = _tail.load( std::memory_order_relaxed );
+
+            for ( ;; ) {
+                cell& l_cell = _cells[ l_position & ( Capacity - 1 ) ];
+
+                const size_t l_sequence =
+                    l_cell.sequence.load( std::memory_order_acquire );
+                const auto l_difference =
+                    static_cast< ptrdiff_t >( l_sequence - l_position );
+
+                if ( l_difference == 0 ) {
+                    if ( _tail.compare_exchange_weak(
+                             l_position, ( l_position + 1 ),
+                             std::memory_order_relaxed ) ) {
+                        l_cell.value = std::move( _value );
+                        l_cell.sequence.store( ( l_position + 1 ),
+                                               std::memory_order_release );
+
+                        break;
+                    }
+
+                } else if ( l_difference < 0 ) {
+                    goto EXIT;
+
+                } else {
+                    l_position = _tail.load( std::memory_order_relaxed );
+                }
+            }
+
+            l_returnValue = true;
+        }
+
+    EXIT:
+        return ( l_returnValue );
+    }
+
+    // False if empty
+    auto pop( T& _value ) -> bool {
+        bool l_returnValue = false;
+
+        {
+            size_t l_position = _head.load( std::memory_order_relaxed );
+
+            for ( ;; ) {
+                cell& l_cell = _cells[ l_position & ( Capacity - 1 ) ];
+
+                const size_t l_sequence =
+                    l_cell.sequence.load( std::memory_order_acquire );
+                const auto l_difference = static_cast< ptrdiff_t >(
+                    l_sequence - ( l_position + 1 ) );
+
+                if ( l_difference == 0 ) {
+                    if ( _head.compare_exchange_weak(
+                             l_position, ( l_position + 1 ),
+                             std::memory_order_relaxed ) ) {
+                        _value = std::move( l_cell.value );
+                        l_cell.sequence.store( ( l_position + Capacity ),
+                                               std::memory_order_release );
+
+                        break;
+                    }
+
+                } else if ( l_difference < 0 ) {
+                    goto EXIT;
+
+                } else {
+                    l_position = _head.load( std::memory_order_relaxed );
+                }
+            }
+
+            l_returnValue = true;
+        }
+
+    EXIT:
+        return ( l_returnValue );
+    }
+
+private:
+    struct cell {
+        std::atomic< size_t > sequence;
+        T value;
+    };
+
+    alignas( g_cacheLineSize ) std::array< cell, Capacity > _cells;
+    alignas( g_cacheLineSize ) std::atomic< size_t > _head = 0;
+    alignas( g_cacheLineSize ) std::atomic< size_t > _tail = 0;
+};
+
+template < typename T, size_t Capacity >
+using mpmc_t = mpmc< T, Capacity >;
+
+// Bounded Chase-Lev work-stealing deque
+// Owner pushes and pops at bottom, thieves take from top. Memory orders follow
+// Le et al., "Correct and efficient work-stealing for weak memory models"
+template < typename T, size_t Capacity >
+    requires( ( Capacity > 1 ) && ( ( Capacity & ( Capacity - 1 ) ) == 0 ) )
+struct chaseLev {
+    chaseLev() = default;
+    chaseLev( const chaseLev& ) = delete;
+    chaseLev( chaseLev&& ) = delete;
+    ~chaseLev() = default;
+    auto operator=( const chaseLev& ) -> chaseLev& = delete;
+    auto operator=( chaseLev&& ) -> chaseLev& = delete;
+
+    enum class steal_t : uint8_t {
+        success = 0,
+        empty,
+        // Lost race against owner or another thief
+        contended,
+    };
+
+    // Owner only, false if full
+    auto push( T _value ) -> bool {
+        bool l_returnValue = false;
+
+        {
+            const ptrdiff_t l_bottom =
+                _bottom.load( std::memory_order_relaxed );
+            const ptrdiff_t l_top = _top.load( std::memory_order_acquire );
+
+            if ( ( l_bottom - l_top ) >=
+                 static_cast< ptrdiff_t >( Capacity ) ) {
+                goto EXIT;
+            }
+
+            _cells[ l_bottom & ( Capacity - 1 ) ].store(
+                _value, std::memory_order_relaxed );
+
+            // Publishes value to thieves acquiring bottom
+            _bottom.store( ( l_bottom + 1 ), std::memory_order_release );
+
+            l_returnValue = true;
+        }
+
+    EXIT:
+        return ( l_returnValue );
+    }
+
+    // Owner only, false if empty
+    auto pop( T& _value ) -> bool {
+        bool l_returnValue = false;
+
+        {
+            const ptrdiff_t l_bottom =
+                ( _bottom.load( std::memory_order_relaxed ) - 1 );
+
+            _bottom.store( l_bottom, std::memory_order_relaxed );
+
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+
+            ptrdiff_t l_top = _top.load( std::memory_order_relaxed );
+
+            if ( l_top > l_bottom ) {
+                _bottom.store( ( l_bottom + 1 ), std::memory_order_relaxed );
+
+                goto EXIT;
+            }
+
+            _value = _cells[ l_bottom & ( Capacity - 1 ) ].load(
+                std::memory_order_relaxed );
+
+            // Last element, race thieves for it
+            if ( l_top == l_bottom ) {
+                l_returnValue = _top.compare_exchange_strong(
+                    l_top, ( l_top + 1 ), std::memory_order_seq_cst,
+                    std::memory_order_relaxed );
+
+                _bottom.store( ( l_bottom + 1 ), std::memory_order_relaxed );
+
+                goto EXIT;
+            }
+
+            l_returnValue = true;
+        }
+
+    EXIT:
+        return ( l_returnValue );
+    }
+
+    // Any thread
+    auto steal( T& _value ) -> steal_t {
+        steal_t l_returnValue = steal_t::empty;
+
+        {
+            ptrdiff_t l_top = _top.load( std::memory_order_acquire );
+
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+
+            const ptrdiff_t l_bottom =
+                _bottom.load( std::memory_order_acquire );
+
+            if ( l_top >= l_bottom ) {
+                goto EXIT;
+            }
+
+            const T l_value = _cells[ l_top & ( Capacity - 1 ) ].load(
+                std::memory_order_relaxed );
+
+            if ( !_top.compare_exchange_strong( l_top, ( l_top + 1 ),
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed ) ) {
+                l_returnValue = steal_t::contended;
+
+                goto EXIT;
+            }
+
+            _value = l_value;
+
+            l_returnValue = steal_t::success;
+        }
+
+    EXIT:
+        return ( l_returnValue );
+    }
+
+private:
+    alignas( g_cacheLineSize ) std::atomic< ptrdiff_t > _top = 0;
+    alignas( g_cacheLineSize ) std::atomic< ptrdiff_t > _bottom = 0;
+    alignas( g_cacheLineSize )
+        std::array< std::atomic< T >, Capacity > _cells{};
+};
+
+template < typename T, size_t Capacity >
+using chaseLev_t = chaseLev< T, Capacity >;
+
+} // namespace queue
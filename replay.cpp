@@ -0,0 +1,355 @@
+#include "replay.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "log.hpp"
+
+namespace replay {
+
+namespace {
+
+// Recording calls write(2) once this much is buffered
+inline constexpr const size_t g_bufferSize = 65536;
+
+inline constexpr const uint8_t g_isDownFlag = 0b1;
+inline constexpr const uint8_t g_isRepeatFlag = 0b10;
+
+mode_t g_mode = mode_t::off;
+
+// Record mode
+int g_fileDescriptor = -1;
+std::vector< std::byte > g_buffer;
+
+// Replay mode
+const std::byte* g_data = nullptr;
+size_t g_size = 0;
+size_t g_offset = 0;
+
+template < typename T >
+    requires( std::is_trivially_copyable_v< T > )
+void append( const T& _value ) {
+    const size_t l_offset = g_buffer.size();
+
+    g_buffer.resize( l_offset + sizeof( T ) );
+
+    std::memcpy( ( g_buffer.data() + l_offset ), &_value, sizeof( T ) );
+}
+
+template < typename T >
+    requires( std::is_trivially_copyable_v< T > )
+auto consume( T& _value ) -> bool {
+    bool l_returnValue = false;
+
+    if ( ( g_offset + sizeof( T ) ) <= g_size ) {
+        std::memcpy( &_value, ( g_data + g_offset ), sizeof( T ) );
+
+        g_offset += sizeof( T );
+
+        l_returnValue = true;
+    }
+
+    return ( l_returnValue );
+}
+
+void flush() {
+    size_t l_written = 0;
+
+    while ( l_written < g_buffer.size() ) {
+        const ssize_t l_result =
+            ::write( g_fileDescriptor, ( g_buffer.data() + l_written ),
+                     ( g_buffer.size() - l_written ) );
+
+        if ( l_result <= 0 ) {
+            log::error( "Writing recording" );
+
+            break;
+        }
+
+        l_written += l_result;
+    }
+
+    g_buffer.clear();
+}
+
+auto openRecording( std::string_view _path ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        g_fileDescriptor =
+            open( std::string( _path ).c_str(),
+                  ( O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC ), 0644 );
+
+        if ( g_fileDescriptor == -1 ) {
+            log::error( std::format( "Opening '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        g_buffer.reserve( g_bufferSize );
+
+        append( g_magic );
+        append( g_version );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+auto mapRecording( std::string_view _path ) -> bool {
+    bool l_returnValue = false;
+
+    const int l_fileDescriptor =
+        open( std::string( _path ).c_str(), ( O_RDONLY | O_CLOEXEC ) );
+
+    {
+        if ( l_fileDescriptor == -1 ) {
+            log::error( std::format( "Opening '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        struct stat l_stat{};
+
+        if ( ( fstat( l_fileDescriptor, &l_stat ) == -1 ) ||
+             !l_stat.st_size ) {
+            log::error( std::format( "Querying size of '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        void* l_data = mmap( nullptr, l_stat.st_size, PROT_READ, MAP_PRIVATE,
+                             l_fileDescriptor, 0 );
+
+        if ( l_data == MAP_FAILED ) {
+            log::error( std::format( "Mapping '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        // Read front to back exactly once
+        madvise( l_data, l_stat.st_size, MADV_SEQUENTIAL );
+
+        g_data = static_cast< const std::byte* >( l_data );
+        g_size = l_stat.st_size;
+        g_offset = 0;
+
+        uint32_t l_magic = 0;
+        uint32_t l_version = 0;
+
+        if ( !consume( l_magic ) || !consume( l_version ) ||
+             ( l_magic != g_magic ) || ( l_version != g_version ) ) {
+            log::error( std::format( "'{}' is not a version {} recording",
+                                     _path, g_version ) );
+
+            munmap( const_cast< std::byte* >( g_data ), g_size );
+
+            g_data = nullptr;
+            g_size = 0;
+
+            goto EXIT;
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    if ( l_fileDescriptor != -1 ) {
+        close( l_fileDescriptor );
+    }
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto init( mode_t _mode, std::string_view _path ) -> bool {
+    log::variable( _path );
+
+    bool l_returnValue = false;
+
+    {
+        if ( g_mode != mode_t::off ) {
+            log::error( "Already initialized" );
+
+            goto EXIT;
+        }
+
+        if ( _mode == mode_t::record ) {
+            if ( !openRecording( _path ) ) {
+                goto EXIT;
+            }
+
+            log::info( "Recording input to '{}'", _path );
+
+        } else if ( _mode == mode_t::replay ) {
+            if ( !mapRecording( _path ) ) {
+                goto EXIT;
+            }
+
+            log::info( "Replaying input from '{}', {} bytes", _path, g_size );
+        }
+
+        g_mode = _mode;
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void quit() {
+    if ( g_mode == mode_t::record ) {
+        flush();
+
+        close( g_fileDescriptor );
+
+        g_fileDescriptor = -1;
+
+    } else if ( g_mode == mode_t::replay ) {
+        munmap( const_cast< std::byte* >( g_data ), g_size );
+
+        g_data = nullptr;
+        g_size = 0;
+        g_offset = 0;
+    }
+
+    g_mode = mode_t::off;
+}
+
+auto mode() -> mode_t {
+    return ( g_mode );
+}
+
+auto toEvent( const SDL_Event& _event ) -> event_t {
+    event_t l_returnValue;
+
+    l_returnValue.timestamp = _event.common.timestamp;
+    l_returnValue.type = _event.type;
+
+    if ( ( _event.type == SDL_EVENT_KEY_DOWN ) ||
+         ( _event.type == SDL_EVENT_KEY_UP ) ) {
+        l_returnValue.data1 = _event.key.scancode;
+        l_returnValue.isDown = _event.key.down;
+        l_returnValue.isRepeat = _event.key.repeat;
+
+    } else if ( ( _event.type >= SDL_EVENT_WINDOW_SHOWN ) &&
+                ( _event.type <= SDL_EVENT_WINDOW_OCCLUDED ) ) {
+        l_returnValue.data1 = _event.window.data1;
+        l_returnValue.data2 = _event.window.data2;
+    }
+
+    return ( l_returnValue );
+}
+
+auto toSDL( const event_t& _event ) -> SDL_Event {
+    SDL_Event l_returnValue{};
+
+    l_returnValue.type = _event.type;
+    l_returnValue.common.timestamp = _event.timestamp;
+
+    if ( ( _event.type == SDL_EVENT_KEY_DOWN ) ||
+         ( _event.type == SDL_EVENT_KEY_UP ) ) {
+        l_returnValue.key.scancode =
+            static_cast< SDL_Scancode >( _event.data1 );
+        l_returnValue.key.down = _event.isDown;
+        l_returnValue.key.repeat = _event.isRepeat;
+
+    } else if ( ( _event.type >= SDL_EVENT_WINDOW_SHOWN ) &&
+                ( _event.type <= SDL_EVENT_WINDOW_OCCLUDED ) ) {
+        l_returnValue.window.data1 = _event.data1;
+        l_returnValue.window.data2 = _event.data2;
+    }
+
+    return ( l_returnValue );
+}
+
+// Sample, ticks, alpha, direction, button, event count, then per event
+// timestamp, type, data1, data2, flags
+void write( const frame_t& _frame ) {
+    if ( g_mode != mode_t::record ) {
+        return;
+    }
+
+    append( _frame.sampleNanoseconds );
+    append( _frame.ticks );
+    append( _frame.alpha );
+    append( _frame.input.direction );
+    append( _frame.input.button );
+    append( static_cast< uint16_t >( _frame.events.size() ) );
+
+    for ( const event_t& l_event : _frame.events ) {
+        const auto l_flags = static_cast< uint8_t >(
+            ( l_event.isDown ? g_isDownFlag : 0 ) |
+            ( l_event.isRepeat ? g_isRepeatFlag : 0 ) );
+
+        append( l_event.timestamp );
+        append( l_event.type );
+        append( l_event.data1 );
+        append( l_event.data2 );
+        append( l_flags );
+    }
+
+    if ( g_buffer.size() >= g_bufferSize ) {
+        flush();
+    }
+}
+
+auto read( frame_t& _frame ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        if ( g_mode != mode_t::replay ) {
+            goto EXIT;
+        }
+
+        uint16_t l_eventCount = 0;
+
+        // Clean end of recording
+        if ( g_offset == g_size ) {
+            goto EXIT;
+        }
+
+        if ( !consume( _frame.sampleNanoseconds ) ||
+             !consume( _frame.ticks ) || !consume( _frame.alpha ) ||
+             !consume( _frame.input.direction ) ||
+             !consume( _frame.input.button ) || !consume( l_eventCount ) ) {
+            log::warning( "Recording ends inside a frame" );
+
+            goto EXIT;
+        }
+
+        _frame.events.resize( l_eventCount );
+
+        for ( event_t& l_event : _frame.events ) {
+            uint8_t l_flags = 0;
+
+            if ( !consume( l_event.timestamp ) || !consume( l_event.type ) ||
+                 !consume( l_event.data1 ) || !consume( l_event.data2 ) ||
+                 !consume( l_flags ) ) {
+                log::warning( "Recording ends inside an event" );
+
+                goto EXIT;
+            }
+
+            l_event.isDown = !!( l_flags & g_isDownFlag );
+            l_event.isRepeat = !!( l_flags & g_isRepeatFlag );
+        }
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace replay
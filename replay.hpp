@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "controls.hpp"
+
+// Input recording and replay
+// Records everything that decides what a frame simulates and draws:
+// events, polled input, simulation ticks and interpolation. Replaying a
+// recording gives the same workload on every run
+namespace replay {
+
+enum class mode_t : uint8_t {
+    off = 0,
+    record,
+    replay,
+};
+
+inline constexpr const uint32_t g_magic = 0x594c5052; // "RPLY"
+inline constexpr const uint32_t g_version = 1;
+
+// Fields runtime reads from SDL_Event
+using event_t = struct event {
+    event() = default;
+    event( const event& ) = default;
+    event( event&& ) = default;
+    ~event() = default;
+    auto operator=( const event& ) -> event& = default;
+    auto operator=( event&& ) -> event& = default;
+
+    uint64_t timestamp = 0;
+    uint32_t type = 0;
+    // Scancode for keys, size for windows
+    int32_t data1 = 0;
+    int32_t data2 = 0;
+    bool isDown = false;
+    bool isRepeat = false;
+};
+
+using frame_t = struct frame {
+    frame() = default;
+    frame( const frame& ) = default;
+    frame( frame&& ) = default;
+    ~frame() = default;
+    auto operator=( const frame& ) -> frame& = default;
+    auto operator=( frame&& ) -> frame& = default;
+
+    // SDL_GetTicksNS when events were handled
+    uint64_t sampleNanoseconds = 0;
+    uint32_t ticks = 0;
+    float alpha = 0;
+    controls::input_t input;
+    std::vector< event_t > events;
+};
+
+// Record truncates _path, replay reads all of it
+auto init( mode_t _mode, std::string_view _path ) -> bool;
+// Record writes what is still buffered
+void quit();
+
+auto mode() -> mode_t;
+
+auto toEvent( const SDL_Event& _event ) -> event_t;
+auto toSDL( const event_t& _event ) -> SDL_Event;
+
+// Record mode, appends _frame
+void write( const frame_t& _frame );
+// Replay mode, false after last frame
+auto read( frame_t& _frame ) -> bool;
+
+} // namespace replay
@@ -0,0 +1,213 @@
+#include "report.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+#include "log.hpp"
+#include "profile.hpp"
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+inline constexpr const size_t g_phaseCount =
+    static_cast< size_t >( report::phase_t::count );
+
+inline constexpr const std::array< std::string_view, g_phaseCount >
+    g_phaseNames = {
+        "events", "stream", "simulation", "render", "submit",
+};
+
+using frame_t = struct frame {
+    frame() = default;
+    frame( const frame& ) = default;
+    frame( frame&& ) = default;
+    ~frame() = default;
+    auto operator=( const frame& ) -> frame& = default;
+    auto operator=( frame&& ) -> frame& = default;
+
+    int64_t frameTime = 0;
+    std::array< int64_t, g_phaseCount > phaseTimes{};
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+};
+
+// Game thread only, write runs after it stopped
+bool g_isEnabled = false;
+std::vector< frame_t > g_frames;
+// Current frame
+frame_t g_frame;
+report::scope_t* g_scope = nullptr;
+int64_t g_lastTimestamp = 0;
+profile::allocations_t g_lastAllocations;
+
+auto now() -> int64_t {
+    return ( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                 clock::now().time_since_epoch() )
+                 .count() );
+}
+
+auto toJSON( const timeSummary_t& _summary ) -> std::string {
+    return ( std::format(
+        "{{\"total\":{:.4f},\"min\":{:.4f},\"mean\":{:.4f},\"p50\":{:.4f},"
+        "\"p95\":{:.4f},\"p99\":{:.4f},\"max\":{:.4f}}}",
+        _summary.total, _summary.min, _summary.mean, _summary.p50,
+        _summary.p95, _summary.p99, _summary.max ) );
+}
+
+} // namespace
+
+namespace report {
+
+scope::scope( phase_t _phase )
+    : _phase( _phase ), _start( 0 ), _parent( g_scope ) {
+    if ( !g_isEnabled ) {
+        return;
+    }
+
+    _start = now();
+
+    // Parent pauses
+    if ( _parent ) {
+        g_frame.phaseTimes[ static_cast< size_t >( _parent->_phase ) ] +=
+            ( _start - _parent->_start );
+    }
+
+    g_scope = this;
+}
+
+scope::~scope() {
+    if ( !g_isEnabled ) {
+        return;
+    }
+
+    const int64_t l_end = now();
+
+    g_frame.phaseTimes[ static_cast< size_t >( _phase ) ] +=
+        ( l_end - _start );
+
+    // Parent resumes
+    if ( _parent ) {
+        _parent->_start = l_end;
+    }
+
+    g_scope = _parent;
+}
+
+void init( size_t _frameCapacity ) {
+    g_frames.reserve( _frameCapacity );
+
+    g_frame = {};
+    g_lastTimestamp = 0;
+    g_lastAllocations = profile::allocations();
+
+    g_isEnabled = true;
+}
+
+void quit() {
+    g_isEnabled = false;
+
+    g_frames = {};
+}
+
+void frame() {
+    if ( !g_isEnabled ) {
+        return;
+    }
+
+    const int64_t l_timestamp = now();
+    const profile::allocations_t l_allocations = profile::allocations();
+
+    // First frame only marks start
+    if ( g_lastTimestamp ) {
+        g_frame.frameTime = ( l_timestamp - g_lastTimestamp );
+        g_frame.allocations = ( l_allocations.count - g_lastAllocations.count );
+        g_frame.allocatedBytes =
+            ( l_allocations.bytes - g_lastAllocations.bytes );
+
+        g_frames.push_back( g_frame );
+    }
+
+    g_frame = {};
+    g_lastTimestamp = l_timestamp;
+    g_lastAllocations = l_allocations;
+}
+
+auto write( std::string_view _path ) -> bool {
+    log::variable( _path );
+
+    bool l_returnValue = false;
+
+    {
+        if ( g_frames.empty() ) {
+            log::error( "No frames to report" );
+
+            goto EXIT;
+        }
+
+        std::ofstream l_outputFileStream{ std::string( _path ) };
+
+        std::vector< int64_t > l_times( g_frames.size() );
+
+        std::ranges::transform( g_frames, l_times.begin(),
+                                &frame_t::frameTime );
+
+        l_outputFileStream << std::format(
+            "{{\"frames\":{},\"frameTimeMilliseconds\":{},"
+            "\"phaseMilliseconds\":{{",
+            g_frames.size(), toJSON( summarize( l_times ) ) );
+
+        for ( size_t l_phase = 0; l_phase < g_phaseCount; l_phase++ ) {
+            std::ranges::transform(
+                g_frames, l_times.begin(), [ & ]( const frame_t& _frame ) {
+                    return ( _frame.phaseTimes[ l_phase ] );
+                } );
+
+            l_outputFileStream << std::format(
+                "{}\"{}\":{}", ( ( l_phase ) ? ( "," ) : ( "" ) ),
+                g_phaseNames[ l_phase ], toJSON( summarize( l_times ) ) );
+        }
+
+        size_t l_allocations = 0;
+        size_t l_allocatedBytes = 0;
+        size_t l_maxAllocations = 0;
+
+        for ( const frame_t& l_frame : g_frames ) {
+            l_allocations += l_frame.allocations;
+            l_allocatedBytes += l_frame.allocatedBytes;
+            l_maxAllocations =
+                std::max( l_maxAllocations, l_frame.allocations );
+        }
+
+        // Uncounted builds report zeros, which would read as a win
+        l_outputFileStream << std::format(
+            "}},\"allocations\":{{\"counted\":{},\"count\":{},\"bytes\":{},"
+            "\"perFrameMean\":{:.2f},\"perFrameMax\":{}}}}}\n",
+            profile::g_isCountingAllocations, l_allocations, l_allocatedBytes,
+            ( static_cast< double >( l_allocations ) /
+              static_cast< double >( g_frames.size() ) ),
+            l_maxAllocations );
+
+        if ( !l_outputFileStream.good() ) {
+            log::error( std::format( "Writing '{}'", _path ) );
+
+            goto EXIT;
+        }
+
+        log::info( "Wrote report of {} frames to '{}'", g_frames.size(),
+                   _path );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+} // namespace report
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// CPU side performance report of a run
+// Game thread times phases of every frame and counts allocations, write
+// emits JSON with percentiles to compare runs against each other. Does
+// nothing until init
+namespace report {
+
+enum class phase_t : uint8_t {
+    events = 0,
+    stream,
+    simulation,
+    render,
+    // bgfx::frame, waits on render thread
+    submit,
+    count,
+};
+
+// Adds time until destruction to _phase of current frame, time of nested
+// scopes only counts for them
+using scope_t = struct scope {
+    explicit scope( phase_t _phase );
+    scope( const scope& ) = delete;
+    scope( scope&& ) = delete;
+    ~scope();
+    auto operator=( const scope& ) -> scope& = delete;
+    auto operator=( scope&& ) -> scope& = delete;
+
+private:
+    phase_t _phase;
+    int64_t _start;
+    scope* _parent;
+};
+
+// Reserves for _frameCapacity frames, more still get recorded
+void init( size_t _frameCapacity );
+void quit();
+
+// Game thread, once per frame
+void frame();
+
+// After game thread stopped
+auto write( std::string_view _path ) -> bool;
+
+} // namespace report
@@ -2,26 +2,33 @@
 
 #include <SDL3/SDL_video.h>
 
-#if 0
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include <assimp/scene.h>
-#endif
 #include <X11/Xlib.h>
 #include <bgfx/bgfx.h>
 #include <bx/math.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <ranges>
+#include <thread>
 #include <vector>
 
 #include "FPS.hpp"
+#include "cull.hpp"
+#include "draw.hpp"
+#include "governor.hpp"
+#include "job.hpp"
 #include "log.hpp"
+#include "mesh.hpp"
+#include "profile.hpp"
+#include "replay.hpp"
+#include "report.hpp"
 #include "shader.hpp"
+#include "stream.hpp"
+#include "texture.hpp"
+#include "timestep.hpp"
 #include "vsync.hpp"
 
-#define STB_IMAGE_IMPLEMENTATION
-// #include <stb/stb_image.h>
-
 namespace {
 
 struct Mesh {
@@ -30,12 +37,252 @@ struct Mesh {
     bgfx::TextureHandle texture{ BGFX_INVALID_HANDLE };
     uint32_t indexCount{ 0 };
     uint32_t vertexCount{ 0 };
+    // Quantized positions are decoded as position * scale + bias
+    bool isQuantized{ false };
+    std::array< float, 4 > positionScale{ 1, 1, 1, 0 };
+    std::array< float, 4 > positionBias{};
+    // Bounding sphere, center and radius
+    std::array< float, 4 > bounds{};
+    std::array< mesh::lod_t, mesh::g_maxLodCount > lods{};
+    uint32_t lodCount{ 0 };
 };
 
 std::vector< Mesh > meshes;
 bgfx::ProgramHandle g_program{ BGFX_INVALID_HANDLE };
+bgfx::ProgramHandle g_quantizedProgram{ BGFX_INVALID_HANDLE };
+// Invalid if renderer cannot instance
+bgfx::ProgramHandle g_instancedProgram{ BGFX_INVALID_HANDLE };
+bgfx::ProgramHandle g_quantizedInstancedProgram{ BGFX_INVALID_HANDLE };
 bgfx::VertexLayout vertexLayout;
+bgfx::VertexLayout quantizedVertexLayout;
 bgfx::UniformHandle s_texColor{ BGFX_INVALID_HANDLE };
+bgfx::UniformHandle u_positionScale{ BGFX_INVALID_HANDLE };
+bgfx::UniformHandle u_positionBias{ BGFX_INVALID_HANDLE };
+bgfx::TextureHandle g_whiteTexture{ BGFX_INVALID_HANDLE };
+mesh::file_t g_model;
+std::array< float, 16 > g_view{};
+std::array< float, 16 > g_projection{};
+
+// Parallel to meshes, known before geometry is streamed in
+cull::bounds_t g_bounds;
+// Meshes before this one are requested
+size_t g_nextStreamedMesh = 0;
+// Only its texture is still to request
+bool g_isNextGeometryRequested = false;
+std::vector< uint32_t > g_visible;
+draw::list_t g_drawList;
+
+// Time per frame spent on creating streamed in resources
+inline constexpr const std::chrono::microseconds g_streamBudget{ 2000 };
+
+// Coarsest level whose error stays under this many pixels on screen is drawn
+inline constexpr const float g_lodPixelError = 1.0F;
+
+// Frames between draw statistics reports
+inline constexpr const size_t g_drawStatisticsInterval = 256;
+
+// Radians per second
+inline constexpr const float g_rotationSpeed = 1.0F;
+
+// Chrome trace written on request and at quit
+inline constexpr const std::string_view g_profilePath = "trace.json";
+inline constexpr const SDL_Scancode g_profileDumpScancode = SDL_SCANCODE_F12;
+
+// Everything advanced by fixed ticks, previous tick kept for interpolation
+using simulation_t = struct simulation {
+    simulation() = default;
+    simulation( const simulation& ) = default;
+    simulation( simulation&& ) = default;
+    ~simulation() = default;
+    auto operator=( const simulation& ) -> simulation& = default;
+    auto operator=( simulation&& ) -> simulation& = default;
+
+    float rotation = 0;
+    // 1 or -1, completed commands reverse it
+    float spin = 1;
+};
+
+timestep::timestep_t g_timestep;
+simulation_t g_simulation;
+simulation_t g_previousSimulation;
+
+// Input sample to bgfx::frame, since last report
+uint64_t g_inputLatencySumNanoseconds = 0;
+uint64_t g_inputLatencyMaxNanoseconds = 0;
+size_t g_inputLatencyFrames = 0;
+
+void tick( simulation_t& _simulation ) {
+    _simulation.rotation +=
+        ( g_rotationSpeed * _simulation.spin * timestep::seconds() );
+}
+
+// Between last two ticks by _alpha
+auto interpolate( const simulation_t& _previous,
+                  const simulation_t& _current,
+                  float _alpha ) -> simulation_t {
+    simulation_t l_returnValue = _current;
+
+    l_returnValue.rotation =
+        ( _previous.rotation +
+          ( ( _current.rotation - _previous.rotation ) * _alpha ) );
+
+    return ( l_returnValue );
+}
+
+// From eye to bounds center
+auto distance( const Mesh& _mesh,
+               const float* _model,
+               const std::array< float, 3 >& _eye ) -> float {
+    const bx::Vec3 l_center = bx::mul(
+        bx::Vec3( _mesh.bounds[ 0 ], _mesh.bounds[ 1 ], _mesh.bounds[ 2 ] ),
+        _model );
+
+    return ( bx::length( bx::sub(
+        l_center, bx::Vec3( _eye[ 0 ], _eye[ 1 ], _eye[ 2 ] ) ) ) );
+}
+
+// Picks level from projected error of each level, _pixelsPerUnit is screen
+// size of one mesh unit at distance 1
+auto selectLod( const Mesh& _mesh, float _distance, float _pixelsPerUnit )
+    -> const mesh::lod_t& {
+    // Nearest point of bounds, inside of it everything is full detail
+    const float l_nearest = ( _distance - _mesh.bounds[ 3 ] );
+
+    size_t l_level = 0;
+
+    if ( l_nearest > 0.0F ) {
+        const float l_pixelsPerUnit = ( _pixelsPerUnit / l_nearest );
+
+        while ( ( ( l_level + 1 ) < _mesh.lodCount ) &&
+                ( ( _mesh.lods[ l_level + 1 ].error * l_pixelsPerUnit ) <=
+                  g_lodPixelError ) ) {
+            l_level++;
+        }
+    }
+
+    return ( _mesh.lods[ l_level ] );
+}
+
+// Geometry of mesh _index, false when stream queue is full
+auto requestGeometry( size_t _index ) -> bool {
+    return ( stream::request(
+        [ _index ] {
+            mesh::prefault( g_model, g_model.records()[ _index ] );
+
+            return ( true );
+        },
+        [ _index ]( bool ) {
+            const mesh::record_t& l_record = g_model.records()[ _index ];
+            const auto l_vertices = g_model.vertices( l_record );
+            const auto l_indices = g_model.indices( l_record );
+
+            Mesh& l_mesh = meshes[ _index ];
+
+            l_mesh.vertexCount = l_record.vertexCount;
+            l_mesh.indexCount = l_record.indexCount;
+            l_mesh.isQuantized = l_record.isQuantized();
+            l_mesh.positionScale = l_record.positionScale;
+            l_mesh.positionBias = l_record.positionBias;
+            l_mesh.bounds = l_record.bounds;
+            l_mesh.lods = l_record.lods;
+            l_mesh.lodCount = l_record.lodCount;
+
+            // Mapping outlives the renderer, no copies
+            l_mesh.vbh = bgfx::createVertexBuffer(
+                bgfx::makeRef( l_vertices.data(), l_vertices.size() ),
+                ( ( l_mesh.isQuantized ) ? ( quantizedVertexLayout )
+                                         : ( vertexLayout ) ) );
+            l_mesh.ibh = bgfx::createIndexBuffer(
+                bgfx::makeRef( l_indices.data(), l_indices.size_bytes() ),
+                BGFX_BUFFER_INDEX32 );
+
+            log::debug( "Loaded mesh[{}]: verts={}, indices={}, lods={}, "
+                        "quantized={}",
+                        _index, l_mesh.vertexCount, l_mesh.indexCount,
+                        l_mesh.lodCount, l_mesh.isQuantized );
+        } ) );
+}
+
+// Texture of mesh _index, false when stream queue is full
+auto requestTexture( size_t _index ) -> bool {
+    const mesh::record_t& l_record = g_model.records()[ _index ];
+
+    // Mapping outlives loaders, name is NUL terminated by cooker
+    const std::string_view l_textureName = l_record.texture.data();
+
+    if ( l_textureName.empty() ) {
+        return ( true );
+    }
+
+    texture::source_t l_source;
+
+    // Embedded
+    if ( l_textureName.starts_with( '*' ) ) {
+        size_t l_embeddedIndex = 0;
+
+        const auto [ l_end, l_error ] = std::from_chars(
+            ( l_textureName.data() + 1 ),
+            ( l_textureName.data() + l_textureName.size() ),
+            l_embeddedIndex );
+
+        if ( ( l_error != std::errc{} ) ||
+             ( l_embeddedIndex >= g_model.textures().size() ) ) {
+            log::warning( "Wrong embedded texture '{}'", l_textureName );
+
+            return ( true );
+        }
+
+        const mesh::texture_t& l_embedded =
+            g_model.textures()[ l_embeddedIndex ];
+
+        l_source.data = g_model.textureData( l_embedded );
+        l_source.width = l_embedded.width;
+        l_source.height = l_embedded.height;
+    }
+
+    return ( texture::load( l_textureName, l_source,
+                            [ _index ]( bgfx::TextureHandle _texture ) {
+                                meshes[ _index ].texture = _texture;
+                            } ) );
+}
+
+// Requests what queues take, rest is retried next frame
+// Loaders block once completions fill up, and streamMeshes runs inside a
+// completion, so requesting everything at once would drop meshes
+void streamPending() {
+    for ( ; g_nextStreamedMesh < meshes.size(); g_nextStreamedMesh++ ) {
+        if ( !g_isNextGeometryRequested ) {
+            if ( !requestGeometry( g_nextStreamedMesh ) ) {
+                return;
+            }
+
+            g_isNextGeometryRequested = true;
+        }
+
+        if ( !requestTexture( g_nextStreamedMesh ) ) {
+            return;
+        }
+
+        g_isNextGeometryRequested = false;
+    }
+}
+
+// Runs on game thread after model is mapped
+void streamMeshes() {
+    meshes.assign( g_model.header().meshCount,
+                   Mesh{ .texture = g_whiteTexture } );
+    g_bounds.resize( meshes.size() );
+
+    for ( auto [ l_index, l_record ] :
+          g_model.records() | std::views::enumerate ) {
+        g_bounds.set( l_index, l_record.bounds );
+    }
+
+    g_nextStreamedMesh = 0;
+    g_isNextGeometryRequested = false;
+
+    streamPending();
+}
 
 auto onWindowResize( runtime::applicationState_t& _applicationState,
                      const float _width,
@@ -59,6 +306,8 @@ EXIT:
 
 auto handleKeyboardState( runtime::applicationState_t& _applicationState )
     -> bool {
+    PROFILE_SCOPE( "handleKeyboardState" );
+
     bool l_returnValue = false;
 
     {
@@ -66,41 +315,73 @@ auto handleKeyboardState( runtime::applicationState_t& _applicationState )
         const size_t l_totalFramesRendered =
             _applicationState.totalFramesRendered;
 
-        if ( l_lastInputFrame < l_totalFramesRendered ) {
-            controls::input_t l_input;
+        // Nobody at keyboard
+        if ( replay::mode() == replay::mode_t::replay ) {
+            _applicationState.currentInput =
+                _applicationState.replayFrame.input;
 
-            {
-                int l_keysAmount = 0;
-                const bool* l_keysState = SDL_GetKeyboardState( &l_keysAmount );
+        } else if ( _applicationState.window &&
+                    ( l_lastInputFrame < l_totalFramesRendered ) ) {
+            int l_keysAmount = 0;
+            const bool* l_keysState = SDL_GetKeyboardState( &l_keysAmount );
+
+            __builtin_assume( l_keysAmount == SDL_SCANCODE_COUNT );
 
-                __builtin_assume( l_keysAmount == SDL_SCANCODE_COUNT );
+            _applicationState.currentInput =
+                _applicationState.controlsTable.sample(
+                    controls::keys_t( l_keysState, l_keysAmount ) );
+        }
 
-                for ( auto [ _index, _isPressed ] :
-                      std::span( l_keysState, l_keysAmount ) |
-                          std::views::enumerate ) {
-                    if ( _isPressed ) {
-                        auto l_scancode = static_cast< SDL_Scancode >( _index );
+        l_lastInputFrame = l_totalFramesRendered;
 
-                        const controls::control_t& l_control =
-                            _applicationState.settings.controls.get(
-                                l_scancode );
+        _applicationState.replayFrame.input = _applicationState.currentInput;
 
-                        if ( l_control.scancode != SDL_SCANCODE_UNKNOWN ) {
-                            l_input.direction |= l_control.input.direction;
-                            l_input.button |= l_control.input.button;
-                        }
-                    }
-                }
-            }
+        l_returnValue = true;
+    }
 
-            _applicationState.currentInput = l_input;
+    return ( l_returnValue );
+}
+
+auto createProgram( const std::string& _vertexShaderPath,
+                    const std::string& _fragmentShaderPath )
+    -> bgfx::ProgramHandle {
+    bgfx::ProgramHandle l_returnValue = BGFX_INVALID_HANDLE;
+
+    {
+        log::info( "Loading vertex shader '{}'", _vertexShaderPath );
+
+        bgfx::ShaderHandle l_vsh = shader::load( _vertexShaderPath );
+
+        if ( !bgfx::isValid( l_vsh ) ) {
+            log::error( "Loading vertex shader" );
+
+            goto EXIT;
         }
 
-        l_lastInputFrame = l_totalFramesRendered;
+        log::info( "Loading fragment shader '{}'", _fragmentShaderPath );
 
-        l_returnValue = true;
+        bgfx::ShaderHandle l_fsh = shader::load( _fragmentShaderPath );
+
+        if ( !bgfx::isValid( l_fsh ) ) {
+            log::error( "Loading fragment shader" );
+
+            bgfx::destroy( l_vsh );
+
+            goto EXIT;
+        }
+
+        log::info( "Compiling shaders" );
+
+        l_returnValue = bgfx::createProgram( l_vsh, l_fsh, true );
+
+        if ( !bgfx::isValid( l_returnValue ) ) {
+            log::error( "Failed to create program" );
+
+            goto EXIT;
+        }
     }
 
+EXIT:
     return ( l_returnValue );
 }
 
@@ -110,312 +391,123 @@ namespace runtime {
 
 // TODO: Implement
 auto applicationState_t::load() -> bool {
+    PROFILE_SCOPE( "load" );
+
     bool l_ok = false;
 
     // --- load shaders
     {
-        // Build program
+        // Build programs
         {
-            log::info( "Loading vertex shader" );
-
-            bgfx::ShaderHandle l_vsh = shader::load( vertexShaderPath );
-
-            if ( !bgfx::isValid( l_vsh ) ) {
-                log::error( "Loading vertex shader" );
+            g_program = createProgram( vertexShaderPath, fragmentShaderPath );
 
+            if ( !bgfx::isValid( g_program ) ) {
                 goto EXIT;
             }
 
-            log::info( "Loading fragment shader" );
-
-            bgfx::ShaderHandle l_fsh = shader::load( fragmentShaderPath );
-
-            if ( !bgfx::isValid( l_fsh ) ) {
-                log::error( "Loading fragment shader" );
-
-                bgfx::destroy( l_vsh );
+            g_quantizedProgram = createProgram( quantizedVertexShaderPath,
+                                                fragmentShaderPath );
 
+            if ( !bgfx::isValid( g_quantizedProgram ) ) {
                 goto EXIT;
             }
 
-            log::info( "Compiling shaders" );
-
-            g_program = bgfx::createProgram( l_vsh, l_fsh, true );
-
-            if ( !bgfx::isValid( g_program ) ) {
-                log::error( "Failed to create program" );
+            // Copies are drawn one by one without these
+            if ( bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING ) {
+                g_instancedProgram = createProgram( instancedVertexShaderPath,
+                                                    fragmentShaderPath );
+                g_quantizedInstancedProgram = createProgram(
+                    quantizedInstancedVertexShaderPath, fragmentShaderPath );
+
+                if ( !bgfx::isValid( g_instancedProgram ) ||
+                     !bgfx::isValid( g_quantizedInstancedProgram ) ) {
+                    log::warning( "Instancing is disabled" );
+
+                    for ( bgfx::ProgramHandle* l_program :
+                          { &g_instancedProgram,
+                            &g_quantizedInstancedProgram } ) {
+                        if ( bgfx::isValid( *l_program ) ) {
+                            bgfx::destroy( *l_program );
+                        }
 
-                goto EXIT;
+                        *l_program = BGFX_INVALID_HANDLE;
+                    }
+                }
             }
         }
 
-        // vertex layout: position (float3) + texcoord0 (float2)
-#if 0
+        // Vertex layout matches mesh::vertex_t
         vertexLayout.begin()
             .add( bgfx::Attrib::Position, 3, bgfx::AttribType::Float )
+            .add( bgfx::Attrib::Normal, 3, bgfx::AttribType::Float )
             .add( bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float )
             .end();
 
+        // Vertex layout matches mesh::quantizedVertex_t
+        // Normal is octahedral encoded
+        quantizedVertexLayout.begin()
+            .add( bgfx::Attrib::Position, 4, bgfx::AttribType::Int16, true )
+            .add( bgfx::Attrib::Normal, 2, bgfx::AttribType::Int16, true )
+            .add( bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half )
+            .end();
+
         s_texColor =
             bgfx::createUniform( "s_texColor", bgfx::UniformType::Sampler );
-#endif
-    }
+        u_positionScale =
+            bgfx::createUniform( "u_positionScale", bgfx::UniformType::Vec4 );
+        u_positionBias =
+            bgfx::createUniform( "u_positionBias", bgfx::UniformType::Vec4 );
 
-    // --- load FBX using Assimp
-#if 0
-    {
-        Assimp::Importer l_importer;
-        const aiScene* l_scene = l_importer.ReadFile(
-            modelPath, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
-                           aiProcess_GenSmoothNormals |
-                           aiProcess_CalcTangentSpace |
-                           aiProcess_ImproveCacheLocality | aiProcess_FlipUVs );
-
-        if ( !l_scene ) {
-            log::error( std::string( "Assimp ReadFile failed: " ) +
-                        l_importer.GetErrorString() );
-            goto EXIT;
-        }
-
-        // Verify counts
+        // Fallback white texture
         {
-            log::info(
-                std::format( "Assimp: meshes = {}, materials = {}, "
-                             "embedded textures = {}",
-                             l_scene->mNumMeshes, l_scene->mNumMaterials,
-                             l_scene->mNumTextures ) );
-            // Print embedded textures if any
-            for ( unsigned l_t = 0; l_t < l_scene->mNumTextures; ++l_t ) {
-                const aiTexture* l_at = l_scene->mTextures[ l_t ];
-                const char* l_name = ( l_at && l_at->mFilename.length )
-                                         ? l_at->mFilename.C_Str()
-                                         : "<no name>";
-                log::debug( std::format(
-                    "Embedded texture[{}]: name='{}' width={} height={}", l_t,
-                    l_name, l_at ? l_at->mWidth : 0,
-                    l_at ? l_at->mHeight : 0 ) );
-            }
-        }
+            static constexpr std::array< uint8_t, 4 > l_white = {
+                0xFF, 0xFF, 0xFF, 0xFF };
 
-        if ( !l_scene->HasMeshes() ) {
-            log::error( "FBX contains no meshes" );
-            goto EXIT;
+            g_whiteTexture = bgfx::createTexture2D(
+                1, 1, false, 1, bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_NONE,
+                bgfx::makeRef( l_white.data(), l_white.size() ) );
         }
+    }
 
-        // Clear any existing meshes
-        meshes.clear();
-
-        // helper to create bgfx texture from raw RGBA pixels
-        auto l_createBgfxTextureFromRgba =
-            [ & ]( const unsigned char* _rgba, int _w,
-                   int _h ) -> bgfx::TextureHandle {
-            const auto l_size = uint32_t( _w * _h * 4 );
-            const bgfx::Memory* l_mem = bgfx::alloc( l_size );
-            memcpy( l_mem->data, _rgba, l_size );
-            return bgfx::createTexture2D( ( uint16_t )_w, ( uint16_t )_h, false,
-                                          1, bgfx::TextureFormat::RGBA8,
-                                          BGFX_TEXTURE_NONE, l_mem );
-        };
-
-        // helper to create texture from aiTexture (embedded)
-        auto l_createTextureFromAiTexture =
-            [ & ]( const aiTexture* _at ) -> bgfx::TextureHandle {
-            if ( !_at )
-                return BGFX_INVALID_HANDLE;
-
-            // compressed (mHeight == 0): at->pcData is a compressed image
-            // (PNG/JPEG) of size at->mWidth
-            if ( _at->mHeight == 0 && _at->mWidth > 0 ) {
-                int l_w = 0, l_h = 0, l_comp = 0;
-                stbi_uc* l_decoded = stbi_load_from_memory(
-                    reinterpret_cast< const stbi_uc* >( _at->pcData ),
-                    static_cast< int >( _at->mWidth ), &l_w, &l_h, &l_comp, 4 );
-                if ( !l_decoded ) {
-                    log::warning(
-                        "Failed to decode embedded compressed texture" );
-                    return BGFX_INVALID_HANDLE;
-                }
-                bgfx::TextureHandle l_th =
-                    l_createBgfxTextureFromRgba( l_decoded, l_w, l_h );
-                stbi_image_free( l_decoded );
-                return l_th;
-            }
-
-            // uncompressed: mWidth = width, mHeight = height and pcData raw
-            // RGBA
-            if ( _at->mHeight > 0 && _at->mWidth > 0 ) {
-                const int l_w = _at->mWidth;
-                const int l_h = _at->mHeight;
-                const auto* l_data =
-                    reinterpret_cast< const unsigned char* >( _at->pcData );
-                return l_createBgfxTextureFromRgba( l_data, l_w, l_h );
-            }
-
-            return BGFX_INVALID_HANDLE;
-        };
-
-        // iterate all meshes
-        for ( unsigned l_mi = 0; l_mi < l_scene->mNumMeshes; ++l_mi ) {
-            const aiMesh* l_am = l_scene->mMeshes[ l_mi ];
-
-            if ( !l_am->HasPositions() ) {
-                log::warning( std::format(
-                    "Mesh[{}] has no positions, skipping", l_mi ) );
-                continue;
-            }
-
-            struct vertex {
-                float x, y, z, u, v;
-            };
-            std::vector< vertex > l_verts;
-            l_verts.reserve( l_am->mNumVertices );
-
-            for ( unsigned l_i = 0; l_i < l_am->mNumVertices; ++l_i ) {
-                vertex l_v{};
-                l_v.x = l_am->mVertices[ l_i ].x;
-                l_v.y = l_am->mVertices[ l_i ].y;
-                l_v.z = l_am->mVertices[ l_i ].z;
-                if ( l_am->HasTextureCoords( 0 ) ) {
-                    l_v.u = l_am->mTextureCoords[ 0 ][ l_i ].x;
-                    l_v.v = l_am->mTextureCoords[ 0 ][ l_i ].y;
-                } else {
-                    l_v.u = 0.0f;
-                    l_v.v = 0.0f;
-                }
-                l_verts.push_back( l_v );
-            }
-
-            // indices
-            std::vector< uint32_t > l_indices;
-            l_indices.reserve( l_am->mNumFaces * 3 );
-            for ( unsigned l_f = 0; l_f < l_am->mNumFaces; ++l_f ) {
-                const aiFace& l_face = l_am->mFaces[ l_f ];
-                if ( l_face.mNumIndices != 3 )
-                    continue;
-                l_indices.push_back( l_face.mIndices[ 0 ] );
-                l_indices.push_back( l_face.mIndices[ 1 ] );
-                l_indices.push_back( l_face.mIndices[ 2 ] );
-            }
+    // --- stream cooked meshes
+    {
+        log::info( "Streaming cooked model" );
 
-            if ( l_verts.empty() || l_indices.empty() ) {
-                log::warning( std::format(
-                    "Mesh[{}] empty verts or indices, skipping", l_mi ) );
-                continue;
-            }
+        meshes.clear();
 
-            // create vertex/index buffers
-            const bgfx::Memory* l_vbMem = bgfx::makeRef(
-                l_verts.data(), uint32_t( l_verts.size() * sizeof( vertex ) ) );
-            const bgfx::Memory* l_ibMem = bgfx::makeRef(
-                l_indices.data(),
-                uint32_t( l_indices.size() * sizeof( uint32_t ) ) );
-
-            Mesh l_mesh{};
-            l_mesh.vertexCount = uint32_t( l_verts.size() );
-            l_mesh.indexCount = uint32_t( l_indices.size() );
-
-            l_mesh.vbh = bgfx::createVertexBuffer( l_vbMem, vertexLayout );
-            l_mesh.ibh = bgfx::createIndexBuffer( l_ibMem );
-
-            // texture: prefer embedded in material or in scene->mTextures
-            l_mesh.texture = BGFX_INVALID_HANDLE;
-
-            if ( l_scene->HasMaterials() ) {
-                const aiMaterial* l_mat =
-                    l_scene->mMaterials[ l_am->mMaterialIndex ];
-                if ( l_mat ) {
-                    aiString l_texPath;
-                    if ( l_mat->GetTextureCount( aiTextureType_DIFFUSE ) > 0 &&
-                         l_mat->GetTexture( aiTextureType_DIFFUSE, 0,
-                                            &l_texPath ) == AI_SUCCESS ) {
-                        std::string l_tpath = l_texPath.C_Str();
-
-                        // Embedded textures in FBX can be referenced as
-                        // "*0", "*1", etc.
-                        if ( !l_tpath.empty() && l_tpath[ 0 ] == '*' ) {
-                            // get embedded texture index
-                            int l_idx = std::atoi( l_tpath.c_str() + 1 );
-                            if ( l_idx >= 0 &&
-                                 l_idx < static_cast< int >(
-                                             l_scene->mNumTextures ) ) {
-                                const aiTexture* l_at =
-                                    l_scene->mTextures[ l_idx ];
-                                l_mesh.texture =
-                                    l_createTextureFromAiTexture( l_at );
-                                if ( !bgfx::isValid( l_mesh.texture ) ) {
-                                    log::warning( std::format(
-                                        "Failed to create texture from "
-                                        "embedded index {}",
-                                        l_idx ) );
-                                }
-                            }
-                        } else {
-                            // try load from file (naive)
-                            int l_w = 0, l_h = 0, l_comp = 0;
-                            stbi_uc* l_data = stbi_load( l_tpath.c_str(), &l_w,
-                                                         &l_h, &l_comp, 4 );
-                            if ( l_data ) {
-                                l_mesh.texture = l_createBgfxTextureFromRgba(
-                                    l_data, l_w, l_h );
-                                stbi_image_free( l_data );
-                            } else {
-                                log::warning(
-                                    std::format( "Failed to load material "
-                                                 "texture from disk: {}",
-                                                 l_tpath ) );
-                            }
-                        }
-                    }
-                }
-            }
+        if ( !stream::request(
+                 [ l_path = modelPath ] {
+                     return ( mesh::map( l_path, g_model ) );
+                 },
+                 []( bool _result ) {
+                     if ( !_result ) {
+                         log::error( "Mapping cooked model" );
 
-            // fallback: if no texture loaded, but scene has embedded
-            // textures (single texture use case)
-            if ( !bgfx::isValid( l_mesh.texture ) &&
-                 l_scene->mNumTextures > 0 ) {
-                // try first embedded texture
-                const aiTexture* l_at = l_scene->mTextures[ 0 ];
-                l_mesh.texture = l_createTextureFromAiTexture( l_at );
-                if ( !bgfx::isValid( l_mesh.texture ) ) {
-                    log::warning(
-                        "Failed to create texture from "
-                        "scene->mTextures[0]" );
-                }
-            }
+                         return;
+                     }
 
-            // final fallback white texture
-            if ( !bgfx::isValid( l_mesh.texture ) ) {
-                const uint8_t l_white[ 4 ] = { 0xFF, 0xFF, 0xFF, 0xFF };
-                const bgfx::Memory* l_mem = bgfx::makeRef( l_white, 4 );
-                l_mesh.texture = bgfx::createTexture2D(
-                    1, 1, false, 1, bgfx::TextureFormat::RGBA8, 0, l_mem );
-            }
+                     streamMeshes();
+                 } ) ) {
+            log::error( "Requesting cooked model" );
 
-            meshes.push_back( l_mesh );
-            log::info(
-                std::format( "Loaded mesh[{}]: verts={}, indices={}, tex={}",
-                             l_mi, l_mesh.vertexCount, l_mesh.indexCount,
-                             bgfx::isValid( l_mesh.texture ) ) );
-        } // end for meshes
+            goto EXIT;
+        }
 
         // setup simple camera view/proj so model is visible
         {
-            float l_view[ 16 ];
-            float l_proj[ 16 ];
-
-            bx::Vec3 l_eye{ 0.0f, 0.0f, -5.0f };
-            bx::Vec3 l_at{ 0.0f, 0.0f, 0.0f };
-            bx::Vec3 l_up{ 0.0f, 1.0f, 0.0f };
+            bx::Vec3 l_eye{ camera.position[ 0 ], camera.position[ 1 ],
+                            camera.position[ 2 ] };
+            bx::Vec3 l_at{ camera.target[ 0 ], camera.target[ 1 ],
+                           camera.target[ 2 ] };
 
-            bx::mtxLookAt( l_view, l_eye, l_at );
-            const float l_fov = 60.0f;
+            bx::mtxLookAt( g_view.data(), l_eye, l_at );
             const float l_aspect = float( width ) / float( height );
-            bx::mtxProj( l_proj, l_fov, l_aspect, 0.1f, 100.0f,
+            bx::mtxProj( g_projection.data(), camera.fieldOfView, l_aspect,
+                         camera.near, camera.far,
                          bgfx::getCaps()->homogeneousDepth );
-            bgfx::setViewTransform( 0, l_view, l_proj );
+            bgfx::setViewTransform( 0, g_view.data(), g_projection.data() );
         }
     }
-#endif
 
     l_ok = true;
 
@@ -423,43 +515,69 @@ EXIT:
     return l_ok;
 }
 
-// TODO: Implement
 auto applicationState_t::unload() -> bool {
     // Destroy mesh resources
-#if 0
-        for ( auto& mesh : meshes ) {
-            if ( bgfx::isValid( mesh.vbh ) ) {
-                bgfx::destroy( mesh.vbh );
-                mesh.vbh = BGFX_INVALID_HANDLE;
-            }
-            if ( bgfx::isValid( mesh.ibh ) ) {
-                bgfx::destroy( mesh.ibh );
-                mesh.ibh = BGFX_INVALID_HANDLE;
-            }
-            if ( bgfx::isValid( mesh.texture ) ) {
-                bgfx::destroy( mesh.texture );
-                mesh.texture = BGFX_INVALID_HANDLE;
-            }
-        }
-        meshes.clear();
-
-        if ( bgfx::isValid( g_program ) ) {
-            bgfx::destroy( g_program );
-            g_program = BGFX_INVALID_HANDLE;
+    for ( auto& mesh : meshes ) {
+        if ( bgfx::isValid( mesh.vbh ) ) {
+            bgfx::destroy( mesh.vbh );
+            mesh.vbh = BGFX_INVALID_HANDLE;
         }
-        if ( bgfx::isValid( s_texColor ) ) {
-            bgfx::destroy( s_texColor );
-            s_texColor = BGFX_INVALID_HANDLE;
+        if ( bgfx::isValid( mesh.ibh ) ) {
+            bgfx::destroy( mesh.ibh );
+            mesh.ibh = BGFX_INVALID_HANDLE;
         }
+    }
+    meshes.clear();
+    g_bounds.clear();
+    g_visible.clear();
+    draw::clear( g_drawList );
 
-        // vertexLayout has no destroy func; it's just an object. Reset it.
-        vertexLayout = bgfx::VertexLayout();
-#endif
+    // Textures are shared between meshes
+    texture::quit();
+
+    if ( bgfx::isValid( g_whiteTexture ) ) {
+        bgfx::destroy( g_whiteTexture );
+        g_whiteTexture = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( g_program ) ) {
+        bgfx::destroy( g_program );
+        g_program = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( g_quantizedProgram ) ) {
+        bgfx::destroy( g_quantizedProgram );
+        g_quantizedProgram = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( g_instancedProgram ) ) {
+        bgfx::destroy( g_instancedProgram );
+        g_instancedProgram = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( g_quantizedInstancedProgram ) ) {
+        bgfx::destroy( g_quantizedInstancedProgram );
+        g_quantizedInstancedProgram = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( s_texColor ) ) {
+        bgfx::destroy( s_texColor );
+        s_texColor = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( u_positionScale ) ) {
+        bgfx::destroy( u_positionScale );
+        u_positionScale = BGFX_INVALID_HANDLE;
+    }
+    if ( bgfx::isValid( u_positionBias ) ) {
+        bgfx::destroy( u_positionBias );
+        u_positionBias = BGFX_INVALID_HANDLE;
+    }
+
+    // vertexLayout has no destroy func; it's just an object. Reset it.
+    vertexLayout = bgfx::VertexLayout();
+    quantizedVertexLayout = bgfx::VertexLayout();
 
     return true;
 }
 
 auto init( applicationState_t& _applicationState ) -> bool {
+    PROFILE_SCOPE( "runtime::init" );
+
     bool l_returnValue = false;
 
     {
@@ -467,11 +585,10 @@ auto init( applicationState_t& _applicationState ) -> bool {
         {
             // Metadata
             {
-                log::info( std::format(
-                    "Window name: '{}', Version: '{}', Identifier: '{}'",
-                    _applicationState.settings.window.name,
-                    _applicationState.settings.version,
-                    _applicationState.settings.identifier ) );
+                log::info( "Window name: '{}', Version: '{}', Identifier: '{}'",
+                           _applicationState.settings.window.name,
+                           _applicationState.settings.version,
+                           _applicationState.settings.identifier );
 
                 if ( !SDL_SetAppMetadata(
                          std::string( _applicationState.settings.window.name )
@@ -491,14 +608,40 @@ auto init( applicationState_t& _applicationState ) -> bool {
             {
                 _applicationState.fragmentShaderPath = "fs.bin";
                 _applicationState.vertexShaderPath = "vs.bin";
-                _applicationState.modelPath = "t.fbx";
+                _applicationState.quantizedVertexShaderPath =
+                    "vs_quantized.bin";
+                _applicationState.instancedVertexShaderPath =
+                    "vs_instanced.bin";
+                _applicationState.quantizedInstancedVertexShaderPath =
+                    "vs_quantized_instanced.bin";
+                _applicationState.modelPath = "t.mesh";
+            }
+
+            _applicationState.controlsTable =
+                controls::compile( _applicationState.settings.controls );
+            _applicationState.player.table = &_applicationState.controlsTable;
+
+            for ( const input::command_t& l_command :
+                  _applicationState.settings.commands ) {
+                _applicationState.player.add( l_command );
             }
 
             // Init SDL sub-systems
-            SDL_Init( SDL_INIT_VIDEO );
+            // Headless needs timers only
+            SDL_Init( ( _applicationState.isHeadless ) ? ( 0 )
+                                                       : ( SDL_INIT_VIDEO ) );
 
             // Window
-            {
+            if ( _applicationState.isHeadless ) {
+                _applicationState.width =
+                    _applicationState.settings.window.width;
+                _applicationState.height =
+                    _applicationState.settings.window.height;
+
+                log::variable( _applicationState.width );
+                log::variable( _applicationState.height );
+
+            } else {
                 _applicationState.window = SDL_CreateWindow(
                     std::string( _applicationState.settings.window.name )
                         .c_str(),
@@ -531,13 +674,17 @@ auto init( applicationState_t& _applicationState ) -> bool {
                 // Build init parameters
                 {
                     l_initParameters.deviceId = 0;
-                    l_initParameters.type = bgfx::RendererType::OpenGL;
+                    l_initParameters.type =
+                        ( ( _applicationState.isHeadless )
+                              ? ( bgfx::RendererType::Noop )
+                              : ( bgfx::RendererType::OpenGL ) );
                     l_initParameters.vendorId = BGFX_PCI_ID_NONE;
 
                     bgfx::PlatformData l_pd{};
 
                     // Build platform data
-                    {
+                    // Noop renderer has nothing to present to
+                    if ( !_applicationState.isHeadless ) {
                         // Get window handle and display
                         {
                             SDL_PropertiesID l_properties =
@@ -587,10 +734,13 @@ auto init( applicationState_t& _applicationState ) -> bool {
 
                     // Build init parameters resolution
                     {
-                        int l_windowWidth = 0;
-                        int l_windowHeight = 0;
+                        auto l_windowWidth =
+                            static_cast< int >( _applicationState.width );
+                        auto l_windowHeight =
+                            static_cast< int >( _applicationState.height );
 
-                        if ( !SDL_GetWindowSize( _applicationState.window,
+                        if ( _applicationState.window &&
+                             !SDL_GetWindowSize( _applicationState.window,
                                                  &l_windowWidth,
                                                  &l_windowHeight ) ) {
                             log::error( "Querying window size" );
@@ -605,6 +755,11 @@ auto init( applicationState_t& _applicationState ) -> bool {
                         log::variable( l_initParameters.resolution.height );
 
                         l_initParameters.resolution.reset = BGFX_RESET_NONE;
+                        l_initParameters.resolution.maxFrameLatency =
+                            _applicationState.settings.window.maxFrameLatency;
+
+                        log::variable(
+                            l_initParameters.resolution.maxFrameLatency );
                     }
 
 #if defined( DEBUG )
@@ -622,9 +777,8 @@ auto init( applicationState_t& _applicationState ) -> bool {
                     goto EXIT;
                 }
 
-                log::info( std::format(
-                    "Current renderer: {}",
-                    bgfx::getRendererName( bgfx::getRendererType() ) ) );
+                log::info( "Current renderer: {}",
+                           bgfx::getRendererName( bgfx::getRendererType() ) );
 
 #if defined( DEBUG )
 
@@ -641,6 +795,24 @@ auto init( applicationState_t& _applicationState ) -> bool {
 
             // TODO: Set new SDL3 things
 
+            // Jobs, game and render threads make up the last two cores
+            if ( !job::init( std::max( std::thread::hardware_concurrency(),
+                                       2U ) -
+                             2 ) ) {
+                log::error( "Initializing job system" );
+
+                goto EXIT;
+            }
+
+            // Asset streaming
+            if ( !stream::init(
+                     std::max( std::thread::hardware_concurrency(), 2U ) -
+                     1 ) ) {
+                log::error( "Initializing asset streaming" );
+
+                goto EXIT;
+            }
+
             // Load resources
             if ( !_applicationState.load() ) {
                 log::error( "Loading application state" );
@@ -657,9 +829,19 @@ auto init( applicationState_t& _applicationState ) -> bool {
             goto EXIT;
         }
 
+        // Frame rate governor
+        if ( !governor::init( _applicationState.settings.window.desiredFPS ) ) {
+            log::error( "Initializing frame rate governor" );
+
+            goto EXIT;
+        }
+
         // FPS
         // Does not fail
-        FPS::init( _applicationState.totalFramesRendered );
+        FPS::init();
+
+        // Simulation starts after loading, so it is not owed ticks for it
+        timestep::reset( g_timestep );
 
         log::debug( "Initialized" );
 
@@ -671,6 +853,8 @@ EXIT:
 }
 
 void quit( applicationState_t& _applicationState ) {
+    profile::dump( g_profilePath );
+
     // Report if SDL error occured before quitting
     {
         const std::string_view l_errorMessage = SDL_GetError();
@@ -684,18 +868,32 @@ void quit( applicationState_t& _applicationState ) {
     // FPS
     FPS::quit();
 
+    // Frame rate governor
+    governor::quit();
+
     // Vsync
     vsync::quit();
 
-    // BGFX
-    bgfx::shutdown();
+    // Asset streaming
+    // Loaders may still reference application state
+    stream::quit();
+
+    // Jobs only run inside iterate
+    job::quit();
 
     // Application state
     {
+        // Handles have to be destroyed before renderer shutdown
         if ( !_applicationState.unload() ) {
             log::error( "Unloading application state" );
         }
 
+        // BGFX
+        bgfx::shutdown();
+
+        // Buffers reference mapped memory until renderer is shut down
+        mesh::unmap( g_model );
+
         // Report if SDL error occured during quitting
         {
             const std::string_view l_errorMessage = SDL_GetError();
@@ -725,6 +923,15 @@ auto event( applicationState_t& _applicationState, const event_t& _event )
 
         // Empty means last event on current frame
         if ( l_isEventEmpty ) {
+            // Live even in replay, latency is measured on this clock
+            _applicationState.inputSampleNanoseconds = SDL_GetTicksNS();
+
+            // Replay keeps recorded sample, so history ticks match it
+            if ( replay::mode() != replay::mode_t::replay ) {
+                _applicationState.replayFrame.sampleNanoseconds =
+                    _applicationState.inputSampleNanoseconds;
+            }
+
             l_returnValue = handleKeyboardState( _applicationState );
 
             if ( !l_returnValue ) {
@@ -733,7 +940,26 @@ auto event( applicationState_t& _applicationState, const event_t& _event )
                 goto EXIT;
             }
 
+            // Key events of this frame are in history by now
+            _applicationState.player.advance(
+                _applicationState.replayFrame.sampleNanoseconds );
+
+            for ( const size_t l_command :
+                  _applicationState.player.completed ) {
+                log::deferred( log::level_t::debug, log::category_t::general,
+                               "Command {} completed", l_command );
+            }
+
+            governor::update();
+
         } else {
+            if ( replay::mode() == replay::mode_t::record ) {
+                _applicationState.replayFrame.events.push_back(
+                    replay::toEvent( _event ) );
+            }
+
+            governor::event( _event );
+
             switch ( _event.type ) {
                 case SDL_EVENT_QUIT: {
                     _applicationState.status = true;
@@ -759,6 +985,23 @@ auto event( applicationState_t& _applicationState, const event_t& _event )
                     break;
                 }
 
+                case SDL_EVENT_KEY_DOWN:
+                case SDL_EVENT_KEY_UP: {
+                    if ( _event.key.down &&
+                         ( _event.key.scancode == g_profileDumpScancode ) ) {
+                        profile::dump( g_profilePath );
+                    }
+
+                    // Held key does not change input
+                    if ( !_event.key.repeat ) {
+                        _applicationState.player.key( _event.key.scancode,
+                                                      _event.key.down,
+                                                      _event.key.timestamp );
+                    }
+
+                    break;
+                }
+
                 default: {
                 }
             }
@@ -772,53 +1015,244 @@ EXIT:
 }
 
 auto iterate( applicationState_t& _applicationState ) -> bool {
+    PROFILE_SCOPE( "iterate" );
+
     bool l_returnValue = false;
 
     {
+        // Create streamed in resources
+        {
+            PROFILE_SCOPE( "stream::drain" );
+            const report::scope_t l_reportScope{ report::phase_t::stream };
+
+            streamPending();
+
+            stream::drain( g_streamBudget );
+        }
+
+        // Logic
+        // TODO: Handle application current input
+        {
+            PROFILE_SCOPE( "simulation" );
+            const report::scope_t l_reportScope{ report::phase_t::simulation };
+
+            replay::frame_t& l_frame = _applicationState.replayFrame;
+
+            // Replay ignores wall clock, so every run simulates alike
+            if ( replay::mode() != replay::mode_t::replay ) {
+                l_frame.ticks =
+                    static_cast< uint32_t >( timestep::advance( g_timestep ) );
+                l_frame.alpha = timestep::alpha( g_timestep );
+            }
+
+            // Every command completed by this frame's input reverses spin
+            // before its ticks
+            if ( _applicationState.player.completed.size() % 2 ) {
+                g_simulation.spin = -g_simulation.spin;
+            }
+
+            _applicationState.player.completed.clear();
+
+            for ( size_t l_tick = l_frame.ticks; l_tick; l_tick-- ) {
+                g_previousSimulation = g_simulation;
+
+                tick( g_simulation );
+            }
+        }
+
         // TODO: Camera
 
         // Render
         {
+            const report::scope_t l_reportScope{ report::phase_t::render };
+
             // Begin frame
             {
                 bgfx::touch( 0 );
             }
 
-            // simple model rotation
-#if 0
-            static double t = 0.0;
-            t += 0.016; // ~60fps step
+            // Rendered state lags simulation by up to one tick
+            const simulation_t l_simulation =
+                interpolate( g_previousSimulation, g_simulation,
+                             _applicationState.replayFrame.alpha );
+
             float model[ 16 ];
-            bx::mtxRotateY( model, float( t ) );
+            bx::mtxRotateY( model, l_simulation.rotation );
+
+            const camera::camera_t& l_camera = _applicationState.camera;
+
+            // Half of viewport height spans tan( fov / 2 ) at distance 1
+            const float l_pixelsPerUnit =
+                ( ( _applicationState.height * 0.5F ) /
+                  bx::tan( bx::toRad( l_camera.fieldOfView ) * 0.5F ) );
+
+            // Every mesh shares model transform, so frustum in model space
+            // tests cooked bounds as they are
+            {
+                std::array< float, 16 > l_modelView;
+                std::array< float, 16 > l_modelViewProjection;
+
+                bx::mtxMul( l_modelView.data(), model, g_view.data() );
+                bx::mtxMul( l_modelViewProjection.data(), l_modelView.data(),
+                            g_projection.data() );
 
-            // submit all meshes
-            for ( const auto& mesh : meshes ) {
-                if ( !bgfx::isValid( mesh.vbh ) || !bgfx::isValid( mesh.ibh ) )
-                    continue;
+                const cull::frustum_t l_frustum =
+                    cull::frustum( l_modelViewProjection.data(),
+                                   bgfx::getCaps()->homogeneousDepth );
 
-                // set model transform (per-mesh you could compute different
-                // transforms)
-                bgfx::setTransform( model );
+                PROFILE_SCOPE( "cull" );
+
+                cull::visible( g_bounds, l_frustum, g_visible );
+            }
+
+            // Queue visible meshes, submission order comes from sort keys
+            {
+                draw::clear( g_drawList );
+
+                const uint32_t l_transform =
+                    draw::transform( g_drawList, model );
+
+                for ( const uint32_t l_index : g_visible ) {
+                    const auto& mesh = meshes[ l_index ];
+
+                    if ( !bgfx::isValid( mesh.vbh ) ||
+                         !bgfx::isValid( mesh.ibh ) ) {
+                        continue;
+                    }
 
-                bgfx::setVertexBuffer( 0, mesh.vbh );
-                bgfx::setIndexBuffer( mesh.ibh );
-                if ( bgfx::isValid( mesh.texture ) ) {
-                    bgfx::setTexture( 0, s_texColor, mesh.texture );
+                    const float l_distance =
+                        distance( mesh, model, l_camera.position );
+                    const auto& l_lod =
+                        selectLod( mesh, l_distance, l_pixelsPerUnit );
+
+                    draw::draw_t l_draw{
+                        .program = ( ( mesh.isQuantized )
+                                         ? ( g_quantizedProgram )
+                                         : ( g_program ) ),
+                        .instancedProgram =
+                            ( ( mesh.isQuantized )
+                                  ? ( g_quantizedInstancedProgram )
+                                  : ( g_instancedProgram ) ),
+                        .vertexBuffer = mesh.vbh,
+                        .indexBuffer = mesh.ibh,
+                        .firstIndex = l_lod.indexOffset,
+                        .indexCount = l_lod.indexCount,
+                        .sampler = s_texColor,
+                        .texture = mesh.texture,
+                        .state = BGFX_STATE_DEFAULT,
+                        .transform = l_transform };
+
+                    if ( mesh.isQuantized ) {
+                        l_draw.uniforms = { {
+                            { .handle = u_positionScale,
+                              .value = mesh.positionScale },
+                            { .handle = u_positionBias,
+                              .value = mesh.positionBias },
+                        } };
+                    }
+
+                    draw::push( g_drawList, l_draw,
+                                ( l_distance / l_camera.far ) );
+                }
+
+                const draw::statistics_t l_statistics =
+                    draw::submit( g_drawList );
+
+                if ( !( _applicationState.totalFramesRendered %
+                        g_drawStatisticsInterval ) ) {
+                    log::deferred(
+                        log::level_t::debug, log::category_t::renderer,
+                        "Draws: {} on {} encoders, instanced {} ({} copies), "
+                        "programs {}, states {} (saved {}), "
+                        "textures {} (saved {}), buffers {} (saved {}), "
+                        "transforms {} (saved {})",
+                        l_statistics.draws, l_statistics.encoders,
+                        l_statistics.instancedDraws,
+                        l_statistics.instances, l_statistics.programChanges,
+                        l_statistics.stateChanges,
+                        l_statistics.stateChangesSaved,
+                        l_statistics.textureBinds,
+                        l_statistics.textureBindsSaved,
+                        l_statistics.bufferBinds,
+                        l_statistics.bufferBindsSaved,
+                        l_statistics.transforms,
+                        l_statistics.transformsSaved );
                 }
-                bgfx::setState( BGFX_STATE_DEFAULT );
-                bgfx::submit( 0, g_program );
             }
-#endif
 
             // TODO: Background
             // TODO: Scene
 
             // End frame
-            bgfx::frame();
+            // Returns once render thread took previous frame
+            {
+                PROFILE_SCOPE( "bgfx::frame" );
+                const report::scope_t l_reportScope{ report::phase_t::submit };
+
+                const uint64_t l_inputLatency =
+                    ( SDL_GetTicksNS() -
+                      _applicationState.inputSampleNanoseconds );
+
+                _applicationState.inputLatencyNanoseconds = l_inputLatency;
+
+                g_inputLatencySumNanoseconds += l_inputLatency;
+                g_inputLatencyMaxNanoseconds =
+                    std::max( g_inputLatencyMaxNanoseconds, l_inputLatency );
+                g_inputLatencyFrames++;
+
+                _applicationState.framesSubmitted = bgfx::frame();
+            }
+
+            if ( !( _applicationState.totalFramesRendered %
+                    g_drawStatisticsInterval ) ) {
+                const uint32_t l_submitted =
+                    _applicationState.framesSubmitted;
+                const uint32_t l_presented =
+                    _applicationState.framesPresented;
+
+                log::deferred(
+                    log::level_t::debug, log::category_t::frame,
+                    "Frame latency: {} frames (submitted {}, presented {}, "
+                    "driver limit {})",
+                    ( l_submitted - l_presented ), l_submitted, l_presented,
+                    _applicationState.settings.window.maxFrameLatency );
+
+                log::deferred( log::level_t::debug, log::category_t::frame,
+                               "Ticks: {}, dropped {}", g_timestep.ticks,
+                               g_timestep.droppedTicks );
+
+                const vsync::statistics_t l_pacing = vsync::statistics();
+
+                log::deferred(
+                    log::level_t::debug, log::category_t::frame,
+                    "Pacing: jitter mean {} ns, max {} ns, missed {} of {}, "
+                    "sleep margin {} ns, predicted frame cost {} ns",
+                    l_pacing.meanJitterNanoseconds,
+                    l_pacing.maxJitterNanoseconds, l_pacing.missed,
+                    ( l_pacing.frames + l_pacing.missed ),
+                    l_pacing.sleepMarginNanoseconds,
+                    l_pacing.predictedWorkNanoseconds );
+
+                vsync::resetStatistics();
+
+                log::deferred(
+                    log::level_t::debug, log::category_t::frame,
+                    "Input to submit: mean {} ns, max {} ns",
+                    ( g_inputLatencySumNanoseconds /
+                      std::max( g_inputLatencyFrames, 1UZ ) ),
+                    g_inputLatencyMaxNanoseconds );
+
+                g_inputLatencySumNanoseconds = 0;
+                g_inputLatencyMaxNanoseconds = 0;
+                g_inputLatencyFrames = 0;
+            }
         }
 
-        // TODO: Logic
-        // TODO: Handle application current input
+        if ( replay::mode() == replay::mode_t::record ) {
+            replay::write( _applicationState.replayFrame );
+        }
+
+        _applicationState.replayFrame.events.clear();
 
         l_returnValue = true;
     }
@@ -7,6 +7,8 @@
 
 #include "camera.hpp"
 #include "controls.hpp"
+#include "input.hpp"
+#include "replay.hpp"
 #include "settings.hpp"
 
 namespace runtime {
@@ -30,12 +32,36 @@ using applicationState_t = struct applicationState {
     float width = logicalWidth;
     float height = logicalHeight;
     std::atomic< size_t > totalFramesRendered = 0;
+    // Game thread hands frames to render thread, which runs one behind
+    std::atomic< uint32_t > framesSubmitted = 0;
+    std::atomic< uint32_t > framesPresented = 0;
+    std::atomic< bool > isGameThreadRunning = false;
 
     camera::camera_t camera;
     settings::settings_t settings;
+    // From settings.controls, compile again after changing bindings
+    controls::table_t controlsTable;
     controls::input_t currentInput;
+    // Keyboard player, from key events
+    input::player_t player;
+    // SDL_GetTicksNS when events of this frame were handled, live clock
+    // in replay too, recorded one is in replayFrame
+    uint64_t inputSampleNanoseconds = 0;
+    // From input sample to handing frame to render thread, last frame
+    uint64_t inputLatencyNanoseconds = 0;
+    // What decided current frame, read from or written to recording
+    replay::frame_t replayFrame;
+    // Game loop stops after this many frames, 0 runs until quit
+    size_t frameLimit = 0;
+    // No window, Noop renderer, nothing is drawn or presented
+    bool isHeadless = false;
 
     std::string vertexShaderPath;
+    // Vertex shader for mesh::quantizedVertex_t
+    std::string quantizedVertexShaderPath;
+    // Model matrix from instance data variants, optional
+    std::string instancedVertexShaderPath;
+    std::string quantizedInstancedVertexShaderPath;
     std::string fragmentShaderPath;
     std::string modelPath;
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include "controls.hpp"
+#include "input.hpp"
 #include "window.hpp"
 
 namespace settings {
@@ -16,6 +19,8 @@ using settings_t = struct settings {
 
     window::window_t window;
     controls::controls_t controls;
+    // Matched on input history of keyboard player
+    std::vector< input::command_t > commands = input::defaultCommands();
     static inline constexpr const std::string_view version = "0.1";
     static inline constexpr const std::string_view identifier =
         window::window_t::name;
@@ -0,0 +1,448 @@
+#include "simplify.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <unordered_map>
+
+namespace simplify {
+
+namespace {
+
+// Collapse may rotate a triangle by less than ~75 degrees
+inline constexpr const double g_minNormalCosine = 0.25;
+
+using vector_t = std::array< double, 3 >;
+
+// Symmetric 4x4 matrix of summed squared plane distances
+using quadric_t = struct quadric {
+    quadric() = default;
+    quadric( const quadric& ) = default;
+    quadric( quadric&& ) = default;
+    ~quadric() = default;
+    auto operator=( const quadric& ) -> quadric& = default;
+    auto operator=( quadric&& ) -> quadric& = default;
+
+    auto operator+=( const quadric& _other ) -> quadric& {
+        for ( size_t l_element = 0; l_element < a.size(); l_element++ ) {
+            a[ l_element ] += _other.a[ l_element ];
+        }
+
+        for ( size_t l_axis = 0; l_axis < b.size(); l_axis++ ) {
+            b[ l_axis ] += _other.b[ l_axis ];
+        }
+
+        c += _other.c;
+        weight += _other.weight;
+
+        return ( *this );
+    }
+
+    // Weighted mean squared distance of _point to accumulated planes
+    [[nodiscard]] auto error( const vector_t& _point ) const -> double {
+        const auto [ l_x, l_y, l_z ] = _point;
+
+        const double l_returnValue =
+            ( ( a[ 0 ] * l_x * l_x ) + ( a[ 3 ] * l_y * l_y ) +
+              ( a[ 5 ] * l_z * l_z ) +
+              ( 2.0 * ( ( a[ 1 ] * l_x * l_y ) + ( a[ 2 ] * l_x * l_z ) +
+                        ( a[ 4 ] * l_y * l_z ) ) ) +
+              ( 2.0 * ( ( b[ 0 ] * l_x ) + ( b[ 1 ] * l_y ) +
+                        ( b[ 2 ] * l_z ) ) ) +
+              c );
+
+        return ( ( weight > 0.0 )
+                     ? ( std::max( ( l_returnValue / weight ), 0.0 ) )
+                     : ( 0.0 ) );
+    }
+
+    // xx, xy, xz, yy, yz, zz
+    std::array< double, 6 > a{};
+    std::array< double, 3 > b{};
+    double c = 0;
+    double weight = 0;
+};
+
+// Candidate half edge collapse
+using collapse_t = struct collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+auto position( const mesh::vertex_t& _vertex ) -> vector_t {
+    return ( vector_t{ _vertex.x, _vertex.y, _vertex.z } );
+}
+
+auto cross( const vector_t& _a, const vector_t& _b, const vector_t& _c )
+    -> vector_t {
+    const vector_t l_edge0 = { ( _b[ 0 ] - _a[ 0 ] ), ( _b[ 1 ] - _a[ 1 ] ),
+                               ( _b[ 2 ] - _a[ 2 ] ) };
+    const vector_t l_edge1 = { ( _c[ 0 ] - _a[ 0 ] ), ( _c[ 1 ] - _a[ 1 ] ),
+                               ( _c[ 2 ] - _a[ 2 ] ) };
+
+    return ( vector_t{ ( ( l_edge0[ 1 ] * l_edge1[ 2 ] ) -
+                         ( l_edge0[ 2 ] * l_edge1[ 1 ] ) ),
+                       ( ( l_edge0[ 2 ] * l_edge1[ 0 ] ) -
+                         ( l_edge0[ 0 ] * l_edge1[ 2 ] ) ),
+                       ( ( l_edge0[ 0 ] * l_edge1[ 1 ] ) -
+                         ( l_edge0[ 1 ] * l_edge1[ 0 ] ) ) } );
+}
+
+auto dot( const vector_t& _lhs, const vector_t& _rhs ) -> double {
+    return ( ( _lhs[ 0 ] * _rhs[ 0 ] ) + ( _lhs[ 1 ] * _rhs[ 1 ] ) +
+             ( _lhs[ 2 ] * _rhs[ 2 ] ) );
+}
+
+// Area weighted plane of every triangle, summed per vertex
+auto quadrics( std::span< const mesh::index_t > _indices,
+               std::span< const mesh::vertex_t > _vertices )
+    -> std::vector< quadric_t > {
+    std::vector< quadric_t > l_returnValue( _vertices.size() );
+
+    for ( size_t l_corner = 0; l_corner < _indices.size(); l_corner += 3 ) {
+        const vector_t l_a = position( _vertices[ _indices[ l_corner + 0 ] ] );
+        const vector_t l_b = position( _vertices[ _indices[ l_corner + 1 ] ] );
+        const vector_t l_c = position( _vertices[ _indices[ l_corner + 2 ] ] );
+
+        vector_t l_normal = cross( l_a, l_b, l_c );
+
+        const double l_length = std::sqrt( dot( l_normal, l_normal ) );
+
+        if ( l_length <= 0.0 ) {
+            continue;
+        }
+
+        for ( double& l_axis : l_normal ) {
+            l_axis /= l_length;
+        }
+
+        const double l_distance = -dot( l_normal, l_a );
+        const double l_weight = ( l_length * 0.5 );
+
+        quadric_t l_plane;
+
+        l_plane.a = { ( l_normal[ 0 ] * l_normal[ 0 ] ),
+                      ( l_normal[ 0 ] * l_normal[ 1 ] ),
+                      ( l_normal[ 0 ] * l_normal[ 2 ] ),
+                      ( l_normal[ 1 ] * l_normal[ 1 ] ),
+                      ( l_normal[ 1 ] * l_normal[ 2 ] ),
+                      ( l_normal[ 2 ] * l_normal[ 2 ] ) };
+        l_plane.b = { ( l_normal[ 0 ] * l_distance ),
+                      ( l_normal[ 1 ] * l_distance ),
+                      ( l_normal[ 2 ] * l_distance ) };
+        l_plane.c = ( l_distance * l_distance );
+
+        for ( double& l_element : l_plane.a ) {
+            l_element *= l_weight;
+        }
+
+        for ( double& l_element : l_plane.b ) {
+            l_element *= l_weight;
+        }
+
+        l_plane.c *= l_weight;
+        l_plane.weight = l_weight;
+
+        for ( size_t l_vertex = 0; l_vertex < 3; l_vertex++ ) {
+            l_returnValue[ _indices[ l_corner + l_vertex ] ] += l_plane;
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+// Vertices on open edges, seams are open too since cooker splits vertices
+// with different attributes
+auto borders( std::span< const mesh::index_t > _indices, size_t _vertexCount )
+    -> std::vector< bool > {
+    std::unordered_map< uint64_t, uint32_t > l_edges;
+
+    l_edges.reserve( _indices.size() );
+
+    auto l_forEachEdge = [ & ]( auto&& _callback ) {
+        for ( size_t l_corner = 0; l_corner < _indices.size(); l_corner++ ) {
+            const mesh::index_t l_from = _indices[ l_corner ];
+            const mesh::index_t l_to =
+                _indices[ ( ( l_corner % 3 ) == 2 ) ? ( l_corner - 2 )
+                                                    : ( l_corner + 1 ) ];
+
+            _callback( ( ( static_cast< uint64_t >(
+                               std::min( l_from, l_to ) )
+                           << 32 ) |
+                         std::max( l_from, l_to ) ),
+                       l_from, l_to );
+        }
+    };
+
+    l_forEachEdge( [ & ]( uint64_t _key, mesh::index_t, mesh::index_t ) {
+        l_edges[ _key ]++;
+    } );
+
+    std::vector< bool > l_returnValue( _vertexCount, false );
+
+    l_forEachEdge(
+        [ & ]( uint64_t _key, mesh::index_t _from, mesh::index_t _to ) {
+            if ( l_edges[ _key ] == 1 ) {
+                l_returnValue[ _from ] = true;
+                l_returnValue[ _to ] = true;
+            }
+        } );
+
+    return ( l_returnValue );
+}
+
+} // namespace
+
+auto bounds( std::span< const mesh::vertex_t > _vertices )
+    -> std::array< float, 4 > {
+    std::array< float, 4 > l_returnValue{};
+
+    std::array< float, 3 > l_minimum;
+    std::array< float, 3 > l_maximum;
+
+    l_minimum.fill( std::numeric_limits< float >::max() );
+    l_maximum.fill( std::numeric_limits< float >::lowest() );
+
+    for ( const mesh::vertex_t& l_vertex : _vertices ) {
+        const std::array< float, 3 > l_position = { l_vertex.x, l_vertex.y,
+                                                    l_vertex.z };
+
+        for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+            l_minimum[ l_axis ] =
+                std::min( l_minimum[ l_axis ], l_position[ l_axis ] );
+            l_maximum[ l_axis ] =
+                std::max( l_maximum[ l_axis ], l_position[ l_axis ] );
+        }
+    }
+
+    if ( !_vertices.empty() ) {
+        for ( size_t l_axis = 0; l_axis < 3; l_axis++ ) {
+            l_returnValue[ l_axis ] =
+                ( ( l_minimum[ l_axis ] + l_maximum[ l_axis ] ) * 0.5F );
+        }
+    }
+
+    for ( const mesh::vertex_t& l_vertex : _vertices ) {
+        l_returnValue[ 3 ] =
+            std::max( l_returnValue[ 3 ],
+                      std::hypot( ( l_vertex.x - l_returnValue[ 0 ] ),
+                                  ( l_vertex.y - l_returnValue[ 1 ] ),
+                                  ( l_vertex.z - l_returnValue[ 2 ] ) ) );
+    }
+
+    return ( l_returnValue );
+}
+
+auto edgeCollapse( std::span< const mesh::index_t > _indices,
+                   std::span< const mesh::vertex_t > _vertices,
+                   size_t _targetIndexCount,
+                   float _maxError,
+                   std::vector< mesh::index_t >& _output ) -> float {
+    double l_returnValue = 0.0;
+
+    _output.assign( _indices.begin(), _indices.end() );
+
+    std::vector< quadric_t > l_quadrics = quadrics( _indices, _vertices );
+    const std::vector< bool > l_isLocked =
+        borders( _indices, _vertices.size() );
+
+    const double l_maxErrorSquared =
+        ( static_cast< double >( _maxError ) * _maxError );
+
+    std::vector< uint32_t > l_remap( _vertices.size() );
+    std::vector< uint32_t > l_offsets( _vertices.size() + 1 );
+    std::vector< uint32_t > l_adjacency;
+    std::vector< bool > l_isTouched;
+    std::vector< collapse_t > l_collapses;
+
+    // Every pass collapses independent edges, cheapest first
+    while ( _output.size() > _targetIndexCount ) {
+        l_collapses.clear();
+
+        for ( size_t l_corner = 0; l_corner < _output.size(); l_corner++ ) {
+            const uint32_t l_a = _output[ l_corner ];
+            const uint32_t l_b =
+                _output[ ( ( l_corner % 3 ) == 2 ) ? ( l_corner - 2 )
+                                                   : ( l_corner + 1 ) ];
+
+            // Each shared edge is seen from both triangles
+            if ( l_a > l_b ) {
+                continue;
+            }
+
+            quadric_t l_quadric = l_quadrics[ l_a ];
+
+            l_quadric += l_quadrics[ l_b ];
+
+            collapse_t l_collapse{
+                .from = l_a,
+                .to = l_b,
+                .cost = std::numeric_limits< double >::max() };
+
+            if ( !l_isLocked[ l_a ] ) {
+                l_collapse.cost =
+                    l_quadric.error( position( _vertices[ l_b ] ) );
+            }
+
+            if ( !l_isLocked[ l_b ] ) {
+                const double l_cost =
+                    l_quadric.error( position( _vertices[ l_a ] ) );
+
+                if ( l_cost < l_collapse.cost ) {
+                    l_collapse = { .from = l_b, .to = l_a, .cost = l_cost };
+                }
+            }
+
+            if ( l_collapse.cost <= l_maxErrorSquared ) {
+                l_collapses.push_back( l_collapse );
+            }
+        }
+
+        if ( l_collapses.empty() ) {
+            break;
+        }
+
+        std::ranges::sort( l_collapses, {}, &collapse_t::cost );
+
+        // Vertex to triangles adjacency
+        {
+            std::ranges::fill( l_offsets, 0 );
+
+            for ( const mesh::index_t l_index : _output ) {
+                l_offsets[ l_index + 1 ]++;
+            }
+
+            std::inclusive_scan( l_offsets.begin(), l_offsets.end(),
+                                 l_offsets.begin() );
+
+            l_adjacency.resize( _output.size() );
+
+            std::vector< uint32_t > l_fill( l_offsets.begin(),
+                                            ( l_offsets.end() - 1 ) );
+
+            for ( size_t l_corner = 0; l_corner < _output.size();
+                  l_corner++ ) {
+                l_adjacency[ l_fill[ _output[ l_corner ] ]++ ] =
+                    ( l_corner / 3 );
+            }
+        }
+
+        std::iota( l_remap.begin(), l_remap.end(), 0 );
+        l_isTouched.assign( _vertices.size(), false );
+
+        const size_t l_trianglesToRemove =
+            ( ( _output.size() - _targetIndexCount ) / 3 );
+        size_t l_removed = 0;
+
+        for ( const collapse_t& l_collapse : l_collapses ) {
+            if ( l_isTouched[ l_collapse.from ] ||
+                 l_isTouched[ l_collapse.to ] ) {
+                continue;
+            }
+
+            const auto l_triangles = std::span( l_adjacency ).subspan(
+                l_offsets[ l_collapse.from ],
+                ( l_offsets[ l_collapse.from + 1 ] -
+                  l_offsets[ l_collapse.from ] ) );
+
+            // Moving vertex must not fold any remaining triangle over
+            bool l_isFlipping = false;
+            size_t l_degenerate = 0;
+
+            for ( const uint32_t l_triangle : l_triangles ) {
+                const auto l_corners =
+                    std::span( _output ).subspan( ( l_triangle * 3 ), 3 );
+
+                if ( std::ranges::find( l_corners, l_collapse.to ) !=
+                     l_corners.end() ) {
+                    l_degenerate++;
+
+                    continue;
+                }
+
+                std::array< vector_t, 3 > l_before;
+                std::array< vector_t, 3 > l_after;
+
+                for ( const auto [ l_vertex, l_index ] :
+                      l_corners | std::views::enumerate ) {
+                    l_before[ l_vertex ] = position( _vertices[ l_index ] );
+                    l_after[ l_vertex ] =
+                        position( _vertices[ ( l_index == l_collapse.from )
+                                                 ? ( l_collapse.to )
+                                                 : ( l_index ) ] );
+                }
+
+                const vector_t l_normalBefore =
+                    cross( l_before[ 0 ], l_before[ 1 ], l_before[ 2 ] );
+                const vector_t l_normalAfter =
+                    cross( l_after[ 0 ], l_after[ 1 ], l_after[ 2 ] );
+
+                // Turning edge-on is as visible as flipping
+                if ( dot( l_normalBefore, l_normalAfter ) <=
+                     ( g_minNormalCosine *
+                       std::sqrt( dot( l_normalBefore, l_normalBefore ) *
+                                  dot( l_normalAfter, l_normalAfter ) ) ) ) {
+                    l_isFlipping = true;
+
+                    break;
+                }
+            }
+
+            if ( l_isFlipping ) {
+                continue;
+            }
+
+            // Neighbourhood of moved vertex is stale until next pass
+            for ( const uint32_t l_triangle : l_triangles ) {
+                for ( size_t l_vertex = 0; l_vertex < 3; l_vertex++ ) {
+                    l_isTouched[ _output[ ( l_triangle * 3 ) + l_vertex ] ] =
+                        true;
+                }
+            }
+
+            l_remap[ l_collapse.from ] = l_collapse.to;
+            l_quadrics[ l_collapse.to ] += l_quadrics[ l_collapse.from ];
+            l_returnValue = std::max( l_returnValue, l_collapse.cost );
+            l_removed += l_degenerate;
+
+            if ( l_removed >= l_trianglesToRemove ) {
+                break;
+            }
+        }
+
+        if ( !l_removed ) {
+            break;
+        }
+
+        // Collapsed triangles drop out
+        {
+            size_t l_write = 0;
+
+            for ( size_t l_corner = 0; l_corner < _output.size();
+                  l_corner += 3 ) {
+                const uint32_t l_a = l_remap[ _output[ l_corner + 0 ] ];
+                const uint32_t l_b = l_remap[ _output[ l_corner + 1 ] ];
+                const uint32_t l_c = l_remap[ _output[ l_corner + 2 ] ];
+
+                if ( ( l_a == l_b ) || ( l_b == l_c ) || ( l_c == l_a ) ) {
+                    continue;
+                }
+
+                _output[ l_write++ ] = l_a;
+                _output[ l_write++ ] = l_b;
+                _output[ l_write++ ] = l_c;
+            }
+
+            _output.resize( l_write );
+        }
+    }
+
+    return ( static_cast< float >( std::sqrt( l_returnValue ) ) );
+}
+
+} // namespace simplify
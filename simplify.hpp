@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "mesh.hpp"
+
+// Offline level of detail generation
+namespace simplify {
+
+// Sphere around bounding box center, radius in w
+auto bounds( std::span< const mesh::vertex_t > _vertices )
+    -> std::array< float, 4 >;
+
+// Quadric error metric half edge collapse, vertices are only referenced so
+// every level shares the vertex buffer
+// Stops at _targetIndexCount or when next collapse would move surface further
+// than _maxError, border and attribute seam vertices stay in place
+// Returns reached error in mesh units
+auto edgeCollapse( std::span< const mesh::index_t > _indices,
+                   std::span< const mesh::vertex_t > _vertices,
+                   size_t _targetIndexCount,
+                   float _maxError,
+                   std::vector< mesh::index_t >& _output ) -> float;
+
+} // namespace simplify
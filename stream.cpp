@@ -0,0 +1,183 @@
+#include "stream.hpp"
+
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "log.hpp"
+#include "queue.hpp"
+
+namespace stream {
+
+namespace {
+
+using task_t = struct task {
+    task() = default;
+    task( const task& ) = delete;
+    task( task&& ) = delete;
+    ~task() = default;
+    auto operator=( const task& ) -> task& = delete;
+    auto operator=( task&& ) -> task& = delete;
+
+    load_t load;
+    complete_t complete;
+    bool result = false;
+};
+
+inline constexpr const size_t g_queueCapacity = 4096;
+
+std::vector< std::jthread > g_loaderThreads;
+queue::mpmc_t< task_t*, g_queueCapacity > g_requests;
+queue::mpmc_t< task_t*, g_queueCapacity > g_completions;
+std::counting_semaphore<> g_requestsAvailable{ 0 };
+std::atomic< size_t > g_pending = 0;
+
+void loader( const std::stop_token& _stopToken ) {
+    for ( ;; ) {
+        g_requestsAvailable.acquire();
+
+        if ( _stopToken.stop_requested() ) {
+            break;
+        }
+
+        task_t* l_task = nullptr;
+
+        if ( !g_requests.pop( l_task ) ) {
+            continue;
+        }
+
+        l_task->result = l_task->load();
+
+        // Main thread drains every frame
+        while ( !g_completions.push( l_task ) ) {
+            // Nobody drains anymore
+            if ( _stopToken.stop_requested() ) {
+                delete l_task;
+
+                return;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+auto init( size_t _threadCount ) -> bool {
+    log::variable( _threadCount );
+
+    bool l_returnValue = false;
+
+    {
+        if ( !g_loaderThreads.empty() ) {
+            log::error( "Already initialized" );
+
+            goto EXIT;
+        }
+
+        if ( !_threadCount ) {
+            log::error( "No loader threads" );
+
+            goto EXIT;
+        }
+
+        g_loaderThreads.reserve( _threadCount );
+
+        for ( size_t l_index = 0; l_index < _threadCount; l_index++ ) {
+            g_loaderThreads.emplace_back( loader );
+        }
+
+        log::info( "Started {} asset loader threads", _threadCount );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void quit() {
+    for ( std::jthread& l_thread : g_loaderThreads ) {
+        l_thread.request_stop();
+    }
+
+    g_requestsAvailable.release( g_loaderThreads.size() );
+
+    g_loaderThreads.clear();
+
+    // Drop everything not completed
+    {
+        task_t* l_task = nullptr;
+
+        while ( g_requests.pop( l_task ) ) {
+            delete l_task;
+        }
+
+        while ( g_completions.pop( l_task ) ) {
+            delete l_task;
+        }
+    }
+
+    g_pending = 0;
+}
+
+auto request( load_t _load, complete_t _complete ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        auto* l_task = new task_t;
+
+        l_task->load = std::move( _load );
+        l_task->complete = std::move( _complete );
+
+        // Callers retry later
+        if ( !g_requests.push( l_task ) ) {
+            log::debug( "Request queue is full" );
+
+            delete l_task;
+
+            goto EXIT;
+        }
+
+        g_pending++;
+
+        g_requestsAvailable.release();
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+auto drain( std::chrono::nanoseconds _budget ) -> size_t {
+    using clock = std::chrono::steady_clock;
+
+    size_t l_returnValue = 0;
+
+    const auto l_deadline = ( clock::now() + _budget );
+
+    task_t* l_task = nullptr;
+
+    while ( g_completions.pop( l_task ) ) {
+        l_task->complete( l_task->result );
+
+        delete l_task;
+
+        g_pending--;
+        l_returnValue++;
+
+        if ( clock::now() >= l_deadline ) {
+            break;
+        }
+    }
+
+    return ( l_returnValue );
+}
+
+auto pending() -> size_t {
+    return ( g_pending );
+}
+
+} // namespace stream
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+// Asset streaming
+// Loads run on loader threads, completions run on the thread that drains
+namespace stream {
+
+// Runs on loader thread
+using load_t = std::function< bool() >;
+// Runs on draining thread with load result
+using complete_t = std::function< void( bool _result ) >;
+
+auto init( size_t _threadCount ) -> bool;
+void quit();
+
+// False when queue is full, nothing is requested then
+auto request( load_t _load, complete_t _complete ) -> bool;
+
+// Runs completions until budget is exhausted, returns amount completed
+auto drain( std::chrono::nanoseconds _budget ) -> size_t;
+
+// Requested but not yet completed
+auto pending() -> size_t;
+
+} // namespace stream
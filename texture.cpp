@@ -0,0 +1,297 @@
+#include "texture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "log.hpp"
+#include "stream.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+namespace texture {
+
+namespace {
+
+// GPU ready container, e.g. produced by cooker
+inline constexpr const std::string_view g_containerExtension = ".dds";
+
+void unmapContainer( void* _data, void* _size ) {
+    munmap( _data, reinterpret_cast< size_t >( _size ) );
+}
+
+using image_t = struct image {
+    image() = default;
+    image( const image& ) = delete;
+    image( image&& ) = delete;
+    ~image() {
+        stbi_image_free( pixels );
+
+        if ( !container.empty() ) {
+            unmapContainer( const_cast< std::byte* >( container.data() ),
+                            reinterpret_cast< void* >( container.size() ) );
+        }
+    }
+    auto operator=( const image& ) -> image& = delete;
+    auto operator=( image&& ) -> image& = delete;
+
+    // Either decoded pixels or mapped container
+    stbi_uc* pixels = nullptr;
+    std::span< const std::byte > container;
+    int width = 0;
+    int height = 0;
+    std::chrono::nanoseconds decodeTime{};
+    // Failure reason is per thread
+    const char* failureReason = nullptr;
+};
+
+using entry_t = struct entry {
+    entry() = default;
+    entry( const entry& ) = delete;
+    entry( entry&& ) = default;
+    ~entry() = default;
+    auto operator=( const entry& ) -> entry& = delete;
+    auto operator=( entry&& ) -> entry& = default;
+
+    bgfx::TextureHandle handle = BGFX_INVALID_HANDLE;
+    bool isLoaded = false;
+    // Requested while decoding
+    std::vector< ready_t > waiters;
+};
+
+// Main thread only
+std::unordered_map< std::string, entry_t > g_entries;
+
+// Prefaulted read-only mapping of whole file
+auto mapContainer( const std::string& _path, image_t& _image ) -> bool {
+    bool l_returnValue = false;
+
+    const int l_fileDescriptor = open( _path.c_str(), O_RDONLY );
+
+    {
+        struct stat l_stat{};
+
+        if ( ( l_fileDescriptor == -1 ) ||
+             ( fstat( l_fileDescriptor, &l_stat ) == -1 ) ||
+             !l_stat.st_size ) {
+            _image.failureReason = "can't open container";
+
+            goto EXIT;
+        }
+
+        void* l_data =
+            mmap( nullptr, l_stat.st_size, PROT_READ,
+                  ( MAP_PRIVATE | MAP_POPULATE ), l_fileDescriptor, 0 );
+
+        if ( l_data == MAP_FAILED ) {
+            _image.failureReason = "can't map container";
+
+            goto EXIT;
+        }
+
+        _image.container =
+            std::span( static_cast< const std::byte* >( l_data ),
+                       static_cast< size_t >( l_stat.st_size ) );
+
+        l_returnValue = true;
+    }
+
+EXIT:
+    if ( l_fileDescriptor != -1 ) {
+        close( l_fileDescriptor );
+    }
+
+    return ( l_returnValue );
+}
+
+// Takes ownership of image pixels or container, invalid handle if renderer
+// rejects it
+auto create( image_t& _image ) -> bgfx::TextureHandle {
+    // Mips and format come from the container itself
+    if ( !_image.container.empty() ) {
+        const bgfx::Memory* l_memory = bgfx::makeRef(
+            _image.container.data(), _image.container.size(), unmapContainer,
+            reinterpret_cast< void* >( _image.container.size() ) );
+
+        _image.container = {};
+
+        bgfx::TextureInfo l_info{};
+
+        const bgfx::TextureHandle l_handle =
+            bgfx::createTexture( l_memory, BGFX_TEXTURE_NONE, 0, &l_info );
+
+        _image.width = l_info.width;
+        _image.height = l_info.height;
+
+        return ( l_handle );
+    }
+
+    const bgfx::Memory* l_memory = bgfx::makeRef(
+        _image.pixels, ( _image.width * _image.height * 4 ),
+        []( void* _pixels, void* ) { stbi_image_free( _pixels ); } );
+
+    _image.pixels = nullptr;
+
+    return ( bgfx::createTexture2D( _image.width, _image.height, false, 1,
+                                    bgfx::TextureFormat::RGBA8,
+                                    BGFX_TEXTURE_NONE, l_memory ) );
+}
+
+void resolve( entry_t& _entry, bgfx::TextureHandle _handle ) {
+    _entry.handle = _handle;
+    _entry.isLoaded = true;
+
+    if ( bgfx::isValid( _handle ) ) {
+        for ( const ready_t& l_ready : _entry.waiters ) {
+            l_ready( _handle );
+        }
+    }
+
+    _entry.waiters.clear();
+}
+
+} // namespace
+
+auto load( const std::string_view _key,
+           const source_t& _source,
+           ready_t _ready ) -> bool {
+    bool l_returnValue = false;
+
+    {
+        auto [ l_iterator, l_isInserted ] =
+            g_entries.try_emplace( std::string( _key ) );
+
+        entry_t& l_entry = l_iterator->second;
+
+        // Already requested
+        if ( !l_isInserted ) {
+            if ( !l_entry.isLoaded ) {
+                l_entry.waiters.emplace_back( std::move( _ready ) );
+
+            } else if ( bgfx::isValid( l_entry.handle ) ) {
+                _ready( l_entry.handle );
+            }
+
+            l_returnValue = true;
+
+            goto EXIT;
+        }
+
+        l_entry.waiters.emplace_back( std::move( _ready ) );
+
+        // Raw texels need no decoding
+        if ( _source.width && _source.height ) {
+            resolve( l_entry,
+                     bgfx::createTexture2D(
+                         _source.width, _source.height, false, 1,
+                         bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_NONE,
+                         bgfx::makeRef( _source.data.data(),
+                                        _source.data.size() ) ) );
+
+            l_returnValue = true;
+
+            goto EXIT;
+        }
+
+        auto l_image = std::make_shared< image_t >();
+
+        l_returnValue = stream::request(
+            [ l_image, l_path = std::string( _key ), _source ] {
+                using clock = std::chrono::steady_clock;
+
+                const auto l_timeStart = clock::now();
+
+                int l_channels = 0;
+
+                if ( l_path.ends_with( g_containerExtension ) ) {
+                    mapContainer( l_path, *l_image );
+
+                } else if ( _source.data.empty() ) {
+                    l_image->pixels =
+                        stbi_load( l_path.c_str(), &l_image->width,
+                                   &l_image->height, &l_channels, 4 );
+
+                } else {
+                    l_image->pixels = stbi_load_from_memory(
+                        reinterpret_cast< const stbi_uc* >(
+                            _source.data.data() ),
+                        _source.data.size(), &l_image->width,
+                        &l_image->height, &l_channels, 4 );
+                }
+
+                l_image->decodeTime = ( clock::now() - l_timeStart );
+
+                const bool l_result =
+                    ( l_image->pixels || !l_image->container.empty() );
+
+                if ( !l_result && !l_image->failureReason ) {
+                    l_image->failureReason = stbi_failure_reason();
+                }
+
+                return ( l_result );
+            },
+            [ l_image, l_key = std::string( _key ) ]( bool _result ) {
+                entry_t& l_entry = g_entries[ l_key ];
+
+                if ( !_result ) {
+                    log::warning( "Failed to decode texture '{}': {}", l_key,
+                                  l_image->failureReason );
+
+                    resolve( l_entry, BGFX_INVALID_HANDLE );
+
+                    return;
+                }
+
+                const size_t l_size =
+                    ( ( l_image->pixels )
+                          ? ( l_image->width * l_image->height * 4 )
+                          : ( l_image->container.size() ) );
+
+                const bgfx::TextureHandle l_handle = create( *l_image );
+
+                if ( !bgfx::isValid( l_handle ) ) {
+                    log::warning( "Renderer rejected texture '{}'", l_key );
+
+                    resolve( l_entry, BGFX_INVALID_HANDLE );
+
+                    return;
+                }
+
+                log::info( "Loaded texture '{}': {}x{}, {} bytes in {:.3f} ms",
+                           l_key, l_image->width, l_image->height, l_size,
+                           std::chrono::duration< double, std::milli >(
+                               l_image->decodeTime )
+                               .count() );
+
+                resolve( l_entry, l_handle );
+            } );
+
+        // Only waiter is this call, so a later load requests again
+        if ( !l_returnValue ) {
+            g_entries.erase( l_iterator );
+        }
+    }
+
+EXIT:
+    return ( l_returnValue );
+}
+
+void quit() {
+    for ( auto& [ l_key, l_entry ] : g_entries ) {
+        if ( bgfx::isValid( l_entry.handle ) ) {
+            bgfx::destroy( l_entry.handle );
+        }
+    }
+
+    g_entries.clear();
+}
+
+} // namespace texture
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+
+// Texture manager
+// Every key is decoded once on loader threads, handles are shared
+namespace texture {
+
+using source_t = struct source {
+    source() = default;
+    source( const source& ) = default;
+    source( source&& ) = default;
+    ~source() = default;
+    auto operator=( const source& ) -> source& = default;
+    auto operator=( source&& ) -> source& = default;
+
+    // Encoded image or raw RGBA8 if width and height are set
+    // Empty means key is a path on disk, ".dds" paths are mapped and
+    // submitted as is
+    std::span< const std::byte > data;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// Runs on main thread once texture is created
+using ready_t = std::function< void( bgfx::TextureHandle _texture ) >;
+
+// Source memory has to outlive decoding and the renderer
+// False when decoding can't be requested, _ready is dropped then
+auto load( const std::string_view _key,
+           const source_t& _source,
+           ready_t _ready ) -> bool;
+
+// Destroys all handles
+void quit();
+
+} // namespace texture
@@ -0,0 +1,39 @@
+#include "timestep.hpp"
+
+namespace timestep {
+
+void reset( timestep_t& _timestep ) {
+    _timestep = timestep_t{};
+    _timestep.last = clock_t::now();
+}
+
+auto advance( timestep_t& _timestep ) -> size_t {
+    size_t l_returnValue = 0;
+
+    const clock_t::time_point l_now = clock_t::now();
+
+    _timestep.accumulator += ( l_now - _timestep.last );
+    _timestep.last = l_now;
+
+    l_returnValue = static_cast< size_t >( _timestep.accumulator / g_tick );
+
+    if ( l_returnValue > g_maxTicksPerFrame ) {
+        _timestep.droppedTicks += ( l_returnValue - g_maxTicksPerFrame );
+
+        l_returnValue = g_maxTicksPerFrame;
+    }
+
+    // Remainder only, dropped ticks are forgotten
+    _timestep.accumulator %= g_tick;
+
+    _timestep.ticks += l_returnValue;
+
+    return ( l_returnValue );
+}
+
+auto alpha( const timestep_t& _timestep ) -> float {
+    return ( std::chrono::duration< float >( _timestep.accumulator ) /
+             std::chrono::duration< float >( g_tick ) );
+}
+
+} // namespace timestep
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// Fixed simulation ticks, independent of render rate
+// Wall time accumulates, whole ticks are consumed and the remainder
+// interpolates between the last two simulated states
+namespace timestep {
+
+using clock_t = std::chrono::steady_clock;
+
+inline constexpr const std::chrono::nanoseconds g_tick =
+    std::chrono::nanoseconds( std::chrono::seconds( 1 ) ) / 60;
+// Slow frame runs at most this many ticks, rest of backlog is dropped so
+// simulation cannot fall further behind every frame
+inline constexpr const size_t g_maxTicksPerFrame = 5;
+
+using timestep_t = struct timestep {
+    timestep() = default;
+    timestep( const timestep& ) = default;
+    timestep( timestep&& ) = default;
+    ~timestep() = default;
+    auto operator=( const timestep& ) -> timestep& = default;
+    auto operator=( timestep&& ) -> timestep& = default;
+
+    clock_t::time_point last;
+    std::chrono::nanoseconds accumulator{};
+    size_t ticks = 0;
+    size_t droppedTicks = 0;
+};
+
+void reset( timestep_t& _timestep );
+
+// Ticks to run for wall time since last call
+auto advance( timestep_t& _timestep ) -> size_t;
+
+// Elapsed part of next tick in [ 0, 1 ), weight of newest state
+auto alpha( const timestep_t& _timestep ) -> float;
+
+// Tick length for simulation math
+constexpr auto seconds() -> float {
+    return ( std::chrono::duration< float >( g_tick ).count() );
+}
+
+} // namespace timestep
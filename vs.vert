@@ -9,12 +9,64 @@ void main() {
 }
 #endif
 
-attribute vec3 a_position;
-attribute vec3 a_normal;
 uniform mat4 u_modelViewProj;
 varying vec3 v_normal;
 
+#if defined(INSTANCED)
+// Model matrix columns per instance
+attribute vec4 i_data0;
+attribute vec4 i_data1;
+attribute vec4 i_data2;
+attribute vec4 i_data3;
+uniform mat4 u_viewProj;
+#endif
+
+#if defined(QUANTIZED)
+// Normalized int16 position in mesh bounds, octahedral normal
+attribute vec4 a_position;
+attribute vec2 a_normal;
+uniform vec4 u_positionScale;
+uniform vec4 u_positionBias;
+
+vec3 decodeOctahedral(vec2 _encoded) {
+    vec3 l_normal = vec3(_encoded, 1.0 - abs(_encoded.x) - abs(_encoded.y));
+
+    if (l_normal.z < 0.0) {
+        l_normal.xy = (1.0 - abs(l_normal.yx)) *
+                      vec2(l_normal.x >= 0.0 ? 1.0 : -1.0,
+                           l_normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+
+    return normalize(l_normal);
+}
+
+vec3 position() {
+    return a_position.xyz * u_positionScale.xyz + u_positionBias.xyz;
+}
+
+vec3 normal() {
+    return decodeOctahedral(a_normal);
+}
+#else
+attribute vec3 a_position;
+attribute vec3 a_normal;
+
+vec3 position() {
+    return a_position;
+}
+
+vec3 normal() {
+    return normalize(a_normal);
+}
+#endif
+
 void main() {
-    gl_Position = u_modelViewProj * vec4(a_position, 1.0);
-    v_normal = normalize(a_normal);
+#if defined(INSTANCED)
+    mat4 l_model = mat4(i_data0, i_data1, i_data2, i_data3);
+
+    gl_Position = u_viewProj * (l_model * vec4(position(), 1.0));
+#else
+    gl_Position = u_modelViewProj * vec4(position(), 1.0);
+#endif
+    v_normal = normal();
 }
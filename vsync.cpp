@@ -2,6 +2,10 @@
 
 #include <sys/time.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+
 #include "common.hpp"
 #include "log.hpp"
 
@@ -9,9 +13,184 @@ namespace vsync {
 
 namespace {
 
+inline constexpr const int64_t g_oneSecondInNanoseconds =
+    ( g_oneSecondInMilliseconds * g_oneMillisecondInNanoseconds );
+
+// Deadline modes
+// Sleeps measured at init for worst wake up lateness
+inline constexpr const size_t g_calibrationSleeps = 16;
+inline constexpr const int64_t g_calibrationSleepNanoseconds =
+    g_oneMillisecondInNanoseconds;
+// Spin budget on top of worst observed wake up lateness
+inline constexpr const int64_t g_marginSafetyNanoseconds = 20'000;
+// Per frame, so margin recovers after a single late wake up
+inline constexpr const int64_t g_marginDecayNanoseconds = 1'000;
+inline constexpr const int64_t g_minMarginNanoseconds = 50'000;
+inline constexpr const int64_t g_maxMarginNanoseconds = 2'000'000;
+
+// Low latency mode
+// Frame cost estimate on top of slowest recent frame
+inline constexpr const int64_t g_workSafetyNanoseconds = 500'000;
+// Per frame, so estimate follows frames getting cheaper
+inline constexpr const int64_t g_workDecayNanoseconds = 20'000;
+
 vsync_t g_vsyncType = vsync_t::unknownVsync;
 float g_desiredFPS = 0;
-struct timespec g_sleepTime, g_startTime, g_endTime;
+int64_t g_periodNanoseconds = 0;
+int64_t g_startNanoseconds = 0;
+// Absolute, 0 until first frame
+int64_t g_deadlineNanoseconds = 0;
+int64_t g_marginNanoseconds = g_maxMarginNanoseconds;
+// Low latency mode, frame starts this long before deadline
+int64_t g_predictedWorkNanoseconds = 0;
+int64_t g_workStartNanoseconds = 0;
+
+size_t g_frames = 0;
+size_t g_missed = 0;
+int64_t g_jitterSumNanoseconds = 0;
+int64_t g_jitterMaxNanoseconds = 0;
+
+auto now() -> int64_t {
+    struct timespec l_time{};
+
+    clock_gettime( CLOCK_MONOTONIC, &l_time );
+
+    return ( ( l_time.tv_sec * g_oneSecondInNanoseconds ) + l_time.tv_nsec );
+}
+
+auto toTimespec( int64_t _nanoseconds ) -> struct timespec {
+    struct timespec l_returnValue{};
+
+    l_returnValue.tv_sec = ( _nanoseconds / g_oneSecondInNanoseconds );
+    l_returnValue.tv_nsec = ( _nanoseconds % g_oneSecondInNanoseconds );
+
+    return ( l_returnValue );
+}
+
+// Returns wake up lateness
+auto sleepUntil( int64_t _nanoseconds ) -> int64_t {
+    const struct timespec l_target = toTimespec( _nanoseconds );
+
+    while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &l_target,
+                             nullptr ) == EINTR ) {
+    }
+
+    return ( now() - _nanoseconds );
+}
+
+void calibrate() {
+    int64_t l_worstLateness = 0;
+
+    for ( size_t l_sleep = 0; l_sleep < g_calibrationSleeps; l_sleep++ ) {
+        l_worstLateness =
+            std::max( l_worstLateness,
+                      sleepUntil( now() + g_calibrationSleepNanoseconds ) );
+    }
+
+    g_marginNanoseconds =
+        std::clamp( ( l_worstLateness + g_marginSafetyNanoseconds ),
+                    g_minMarginNanoseconds, g_maxMarginNanoseconds );
+}
+
+// Sleeps until calibrated margin before _target, then spins
+void waitUntil( int64_t _target ) {
+    int64_t l_now = now();
+
+    if ( l_now >= _target ) {
+        return;
+    }
+
+    const int64_t l_sleepTarget = ( _target - g_marginNanoseconds );
+
+    if ( l_now < l_sleepTarget ) {
+        const int64_t l_lateness = sleepUntil( l_sleepTarget );
+
+        g_marginNanoseconds = std::clamp(
+            std::max( ( l_lateness + g_marginSafetyNanoseconds ),
+                      ( g_marginNanoseconds - g_marginDecayNanoseconds ) ),
+            g_minMarginNanoseconds, g_maxMarginNanoseconds );
+    }
+
+    do {
+        l_now = now();
+    } while ( l_now < _target );
+
+    const int64_t l_jitter = ( l_now - _target );
+
+    g_jitterSumNanoseconds += l_jitter;
+    g_jitterMaxNanoseconds = std::max( g_jitterMaxNanoseconds, l_jitter );
+}
+
+// Frame work itself was too slow, pacing cannot help
+void miss( int64_t _now ) {
+    g_missed++;
+
+    // More than a period behind, restart schedule instead of rushing
+    if ( ( _now - g_deadlineNanoseconds ) > g_periodNanoseconds ) {
+        g_deadlineNanoseconds = _now;
+    }
+
+    g_deadlineNanoseconds += g_periodNanoseconds;
+}
+
+void endDeadline() {
+    // Retargeted during frame, next begin starts new schedule
+    if ( !g_deadlineNanoseconds ) {
+        return;
+    }
+
+    const int64_t l_now = now();
+
+    if ( l_now > g_deadlineNanoseconds ) {
+        miss( l_now );
+
+        return;
+    }
+
+    waitUntil( g_deadlineNanoseconds );
+
+    g_frames++;
+
+    // Next deadline from schedule, not from wake up, so error cannot drift
+    g_deadlineNanoseconds += g_periodNanoseconds;
+}
+
+// Waits before frame instead of after it, so input is read as late as
+// predicted frame cost allows
+void beginLowLatency() {
+    if ( !g_deadlineNanoseconds ) {
+        g_deadlineNanoseconds = ( now() + g_periodNanoseconds );
+    }
+
+    waitUntil( g_deadlineNanoseconds - g_predictedWorkNanoseconds );
+
+    g_workStartNanoseconds = now();
+}
+
+void endLowLatency() {
+    if ( !g_deadlineNanoseconds ) {
+        return;
+    }
+
+    const int64_t l_now = now();
+
+    // Follows slowest recent frame right away, cheaper ones slowly
+    g_predictedWorkNanoseconds = std::clamp(
+        std::max( ( ( l_now - g_workStartNanoseconds ) +
+                    g_workSafetyNanoseconds ),
+                  ( g_predictedWorkNanoseconds - g_workDecayNanoseconds ) ),
+        static_cast< int64_t >( 0 ), g_periodNanoseconds );
+
+    if ( l_now > g_deadlineNanoseconds ) {
+        miss( l_now );
+
+        return;
+    }
+
+    g_frames++;
+
+    g_deadlineNanoseconds += g_periodNanoseconds;
+}
 
 } // namespace
 
@@ -29,18 +208,23 @@ auto init( const vsync_t _vsyncType, const float _desiredFPS ) -> bool {
     {
         g_desiredFPS = _desiredFPS;
         g_vsyncType = _vsyncType;
+        g_periodNanoseconds = static_cast< int64_t >(
+            static_cast< float >( g_oneSecondInNanoseconds ) / _desiredFPS );
+        g_deadlineNanoseconds = 0;
+
+        if ( ( _vsyncType == vsync_t::deadline ) ||
+             ( _vsyncType == vsync_t::lowLatency ) ) {
+            calibrate();
 
-        if ( _vsyncType == vsync_t::off ) {
-            g_sleepTime.tv_sec = 0;
-            g_sleepTime.tv_nsec = millisecondsToNanoseconds(
-                g_oneSecondInMilliseconds /
-                static_cast< float >( _desiredFPS ) );
+            log::debug( "Vsync sleep margin calibrated to {} nanoseconds",
+                        g_marginNanoseconds );
         }
 
-        log::info( std ::format( "Setting vsync to {} FPS", _desiredFPS ) );
+        resetStatistics();
 
-        log::debug( std ::format( "Vsync sleep time set to {} nanoseconds",
-                                  g_sleepTime.tv_nsec ) );
+        log::info( "Setting vsync to {} FPS", _desiredFPS );
+
+        log::debug( "Vsync period set to {} nanoseconds", g_periodNanoseconds );
 
         l_returnValue = true;
     }
@@ -51,39 +235,73 @@ EXIT:
 
 void quit() {
     g_desiredFPS = 0;
+    g_periodNanoseconds = 0;
+    g_deadlineNanoseconds = 0;
+}
 
-    if ( g_vsyncType == vsync_t::off ) {
-        g_sleepTime.tv_nsec = 0;
-    }
+void setDesiredFPS( const float _desiredFPS ) {
+    log::variable( _desiredFPS );
+
+    g_desiredFPS = _desiredFPS;
+    g_periodNanoseconds = static_cast< int64_t >(
+        static_cast< float >( g_oneSecondInNanoseconds ) / _desiredFPS );
+    g_deadlineNanoseconds = 0;
 }
 
 void begin() {
     if ( g_vsyncType == vsync_t::off ) {
-        clock_gettime( CLOCK_MONOTONIC, &g_startTime );
+        g_startNanoseconds = now();
+
+    } else if ( ( g_vsyncType == vsync_t::deadline ) &&
+                !g_deadlineNanoseconds ) {
+        g_deadlineNanoseconds = ( now() + g_periodNanoseconds );
+
+    } else if ( g_vsyncType == vsync_t::lowLatency ) {
+        beginLowLatency();
     }
 }
 
 void end() {
     if ( g_vsyncType == vsync_t::off ) {
-        clock_gettime( CLOCK_MONOTONIC, &g_endTime );
+        // Relative, so error of every frame carries over
+        const int64_t l_sleepNanoseconds =
+            ( g_periodNanoseconds - ( now() - g_startNanoseconds ) );
 
-        struct timespec l_adjustedSleepTime{};
+        if ( l_sleepNanoseconds > 0 ) {
+            const struct timespec l_sleepTime =
+                toTimespec( l_sleepNanoseconds );
 
-        {
-            const size_t l_iterationTimeNano =
-                ( g_endTime.tv_nsec - g_startTime.tv_nsec );
+            clock_nanosleep( CLOCK_MONOTONIC, 0, &l_sleepTime, nullptr );
+        }
 
-            long long l_adjustedSleepNano =
-                ( g_sleepTime.tv_nsec - l_iterationTimeNano );
+    } else if ( g_vsyncType == vsync_t::deadline ) {
+        endDeadline();
 
-            l_adjustedSleepNano &= -( l_adjustedSleepNano > 0 );
+    } else if ( g_vsyncType == vsync_t::lowLatency ) {
+        endLowLatency();
+    }
+}
 
-            l_adjustedSleepTime.tv_sec = 0;
-            l_adjustedSleepTime.tv_nsec = l_adjustedSleepNano;
-        }
+auto statistics() -> statistics_t {
+    statistics_t l_returnValue;
 
-        clock_nanosleep( CLOCK_MONOTONIC, 0, &l_adjustedSleepTime, nullptr );
-    }
+    l_returnValue.frames = g_frames;
+    l_returnValue.missed = g_missed;
+    l_returnValue.meanJitterNanoseconds =
+        ( g_jitterSumNanoseconds /
+          static_cast< int64_t >( std::max( g_frames, 1UZ ) ) );
+    l_returnValue.maxJitterNanoseconds = g_jitterMaxNanoseconds;
+    l_returnValue.sleepMarginNanoseconds = g_marginNanoseconds;
+    l_returnValue.predictedWorkNanoseconds = g_predictedWorkNanoseconds;
+
+    return ( l_returnValue );
+}
+
+void resetStatistics() {
+    g_frames = 0;
+    g_missed = 0;
+    g_jitterSumNanoseconds = 0;
+    g_jitterMaxNanoseconds = 0;
 }
 
 } // namespace vsync
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 // Software vsync implementation
@@ -8,12 +9,44 @@ namespace vsync {
 enum class vsync_t : uint8_t {
     off = 0,
     unknownVsync,
+    // Absolute deadlines, sleeps until calibrated margin then spins
+    deadline,
+    // Deadline pacing that waits before frame instead of after it, frame
+    // starts predicted frame cost ahead of deadline
+    lowLatency,
+};
+
+// Deadline modes, lateness of wake ups against their target
+using statistics_t = struct statistics {
+    statistics() = default;
+    statistics( const statistics& ) = default;
+    statistics( statistics&& ) = default;
+    ~statistics() = default;
+    auto operator=( const statistics& ) -> statistics& = default;
+    auto operator=( statistics&& ) -> statistics& = default;
+
+    size_t frames = 0;
+    // Frame work itself ran past deadline, schedule restarted
+    size_t missed = 0;
+    int64_t meanJitterNanoseconds = 0;
+    int64_t maxJitterNanoseconds = 0;
+    int64_t sleepMarginNanoseconds = 0;
+    // Low latency mode
+    int64_t predictedWorkNanoseconds = 0;
 };
 
 auto init( const vsync_t _vsyncType, const float _desiredFPS ) -> bool;
 void quit();
 
+// Next frame starts a new schedule at _desiredFPS
+void setDesiredFPS( const float _desiredFPS );
+
+// Low latency mode waits in begin, others in end
 void begin();
 void end();
 
+// Since init or last reset
+auto statistics() -> statistics_t;
+void resetStatistics();
+
 } // namespace vsync
@@ -19,7 +19,10 @@ using window_t = struct window {
     size_t width = 640;
     size_t height = 480;
     size_t desiredFPS = 60;
+    // Spinning deadline modes are opt-in, they cost power on idle machines
     vsync::vsync_t vsync = vsync::vsync_t::off;
+    // Frames driver may queue ahead of display
+    uint8_t maxFrameLatency = 1;
 };
 
 } // namespace window